@@ -1,5 +1,6 @@
 #define CATCH_CONFIG_COLOUR_NONE
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
 #include <vector>
 #include <deque>
@@ -637,15 +638,72 @@ void advanceImpl(IterType& it, int amount, std::bidirectional_iterator_tag)
 template<class IterType>
 void advanceImpl(IterType& it, int amount, std::input_iterator_tag)
 {
+    assert(amount >= 0 && "input iterators only move forward");
     for(; amount; --amount) ++it;
 }
 
+// deque iterators are random access, += already jumps whole blocks,
+// stream buffer iterators let the library skip inside the get area
+template<class CharT, class Traits>
+void advanceImpl(std::istreambuf_iterator<CharT, Traits>& it, int amount, std::input_iterator_tag)
+{
+    std::advance(it, amount);
+}
+
 template<class IterType>
 void advance(IterType& it, int amount)
 {
     advanceImpl(it, amount, typename
                 std::iterator_traits<IterType>::iterator_category());
 }
+
+// the direction is part of the type, no sign to check at run time
+NAMED_PARAMETER_TYPE(Forward, unsigned);
+NAMED_PARAMETER_TYPE(Backward, unsigned);
+
+template<class IterType>
+void advance(IterType& it, Forward amount)
+{
+    using Category = typename std::iterator_traits<IterType>::iterator_category;
+    if constexpr(std::is_base_of<std::random_access_iterator_tag, Category>::value)
+    {
+        it += static_cast<typename std::iterator_traits<IterType>::difference_type>(amount);
+    }
+    else
+    {
+        for(unsigned n = amount; n; --n) ++it;
+    }
+}
+
+template<class IterType>
+void advance(IterType& it, Backward amount)
+{
+    using Category = typename std::iterator_traits<IterType>::iterator_category;
+    static_assert(
+        std::is_base_of<std::bidirectional_iterator_tag, Category>::value,
+        "only bidirectional iterators can move backward");
+    if constexpr(std::is_base_of<std::random_access_iterator_tag, Category>::value)
+    {
+        it -= static_cast<typename std::iterator_traits<IterType>::difference_type>(amount);
+    }
+    else
+    {
+        for(unsigned n = amount; n; --n) --it;
+    }
+}
+
+template<int Amount, class IterType>
+void advance(IterType& it)
+{
+    if constexpr(Amount >= 0)
+    {
+        advance(it, Forward(Amount));
+    }
+    else
+    {
+        advance(it, Backward(-Amount));
+    }
+}
 }
 }
 
@@ -689,6 +747,128 @@ TEST_CASE("advance for forward_list")
     CHECK((*it) == 3);
 }
 
+TEST_CASE("advance by direction")
+{
+    using My::v2::advance;
+    using My::v2::Forward;
+    using My::v2::Backward;
+    SECTION("vector")
+    {
+        std::vector<int> v(std::cbegin(a), std::cend(a));
+        auto it = std::cbegin(v);
+        advance(it, Forward(3));
+        CHECK((*it) == 3);
+        advance(it, Backward(2));
+        CHECK((*it) == 1);
+        advance<5>(it);
+        CHECK((*it) == 6);
+        advance<-6>(it);
+        CHECK((*it) == 0);
+    }
+    SECTION("list")
+    {
+        std::list<int> v(std::cbegin(a), std::cend(a));
+        auto it = std::cbegin(v);
+        advance(it, Forward(3));
+        CHECK((*it) == 3);
+        advance(it, Backward(2));
+        CHECK((*it) == 1);
+        advance<-1>(it);
+        CHECK((*it) == 0);
+    }
+    SECTION("forward_list")
+    {
+        // advance<-1>(it) or advance(it, Backward(1)) do not compile
+        std::forward_list<int> v(std::cbegin(a), std::cend(a));
+        auto it = std::cbegin(v);
+        advance(it, Forward(3));
+        CHECK((*it) == 3);
+        advance<2>(it);
+        CHECK((*it) == 5);
+        advance<0>(it);
+        CHECK((*it) == 5);
+    }
+}
+
+TEST_CASE("advance for deque")
+{
+    using My::v2::advance;
+    std::deque<int> v(std::cbegin(a), std::cend(a));
+    auto it = std::cbegin(v);
+    advance(it, 0);
+    CHECK((*it) == 0);
+    advance(it, 3);
+    CHECK((*it) == 3);
+    advance(it, -2);
+    CHECK((*it) == 1);
+}
+
+#include <sstream>
+
+TEST_CASE("advance for istreambuf_iterator")
+{
+    // qualified, ADL also finds the std::advance overload for this iterator
+    std::istringstream s("0123456789");
+    std::istreambuf_iterator<char> it(s);
+    My::v2::advance(it, 0);
+    CHECK((*it) == '0');
+    My::v2::advance(it, 3);
+    CHECK((*it) == '3');
+    My::v2::advance(it, 6);
+    CHECK((*it) == '9');
+    My::v2::advance(it, 1);
+    CHECK(it == std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("advance benchmark", "[.][benchmark]")
+{
+    using My::v2::advance;
+    const int amount = 1000000;
+    const std::vector<int> vector(amount + 1);
+    const std::deque<int> deque(amount + 1);
+    const std::list<int> list(amount + 1);
+    const std::forward_list<int> forwardList(amount + 1);
+    std::istringstream stream(std::string(amount + 1, 'x'));
+    BENCHMARK("vector")
+    {
+        auto it = vector.begin();
+        advance(it, amount);
+        return it;
+    };
+    BENCHMARK("deque")
+    {
+        auto it = deque.begin();
+        advance(it, amount);
+        return it;
+    };
+    BENCHMARK("list")
+    {
+        auto it = list.begin();
+        advance(it, amount);
+        return it;
+    };
+    BENCHMARK("forward_list")
+    {
+        auto it = forwardList.begin();
+        advance(it, amount);
+        return it;
+    };
+    BENCHMARK("istreambuf_iterator")
+    {
+        stream.seekg(0);
+        std::istreambuf_iterator<char> it(stream);
+        My::v2::advance(it, amount);
+        return *it;
+    };
+    BENCHMARK("istreambuf_iterator one by one")
+    {
+        stream.seekg(0);
+        std::istreambuf_iterator<char> it(stream);
+        My::v1::advance(it, amount);
+        return *it;
+    };
+}
+
 template<class T>
 class CheckForNull
 {
@@ -709,22 +889,218 @@ public:
     }
 };
 
+// checks once when the pointer is handed over
+// and lets every dereference compile to a plain load
+template<class T, class Check = CheckForNull<T> >
+class CheckOnConstruction
+{
+public:
+    static bool isValidOnConstruction(T const* ptr)
+    {
+        return Check::isValid(ptr);
+    }
+
+    static constexpr bool isValid(T const*)
+    {
+        return true;
+    }
+};
+
+template<class T>
+class AssumeValid
+{
+public:
+    static constexpr bool isValid(T const*)
+    {
+        return true;
+    }
+};
+
+#ifdef NDEBUG
+template<class T>
+using CheckOnceInRelease = CheckOnConstruction<T>;
+#else
+template<class T>
+using CheckOnceInRelease = CheckForNull<T>;
+#endif
+
+#include <memory>
+#include <memory_resource>
+
+template<class T>
+class NewDelete
+{
+public:
+    template<class... Args>
+    static T* create(Args&&... args)
+    {
+        return new T(std::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr)
+    {
+        delete ptr;
+    }
+};
+
+// recycles fixed size slots of T through a free list per type,
+// slots are carved from chunks of ChunkSize and never returned,
+// not thread safe
+template<class T, std::size_t ChunkSize = 256>
+class ObjectPool
+{
+public:
+    template<class... Args>
+    static T* create(Args&&... args)
+    {
+        Slot* slot = allocate();
+        try
+        {
+            return new(slot) T(std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            deallocate(slot);
+            throw;
+        }
+    }
+
+    static void destroy(T* ptr)
+    {
+        if(!ptr)
+        {
+            return;
+        }
+        ptr->~T();
+        deallocate(reinterpret_cast<Slot*>(ptr));
+    }
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    struct Pool
+    {
+        Slot* freeList = nullptr;
+        std::vector<std::unique_ptr<Slot[]> > chunks;
+    };
+
+    static Pool& pool()
+    {
+        static Pool p;
+        return p;
+    }
+
+    static Slot* allocate()
+    {
+        Pool& p = pool();
+        if(!p.freeList)
+        {
+            p.chunks.emplace_back(new Slot[ChunkSize]);
+            Slot* chunk = p.chunks.back().get();
+            for(std::size_t i = 0; i < ChunkSize; ++i)
+            {
+                chunk[i].next = p.freeList;
+                p.freeList = &chunk[i];
+            }
+        }
+        Slot* slot = p.freeList;
+        p.freeList = slot->next;
+        return slot;
+    }
+
+    static void deallocate(Slot* slot)
+    {
+        Pool& p = pool();
+        slot->next = p.freeList;
+        p.freeList = slot;
+    }
+};
+
+// bump allocates T from a monotonic buffer per type,
+// destroy only runs the destructor, memory comes back with release(),
+// not thread safe
+template<class T>
+class MonotonicArena
+{
+public:
+    template<class... Args>
+    static T* create(Args&&... args)
+    {
+        void* memory = resource().allocate(sizeof(T), alignof(T));
+        return new(memory) T(std::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr)
+    {
+        if(ptr)
+        {
+            ptr->~T();
+        }
+    }
+
+    static void release()
+    {
+        resource().release();
+    }
+private:
+    static std::pmr::monotonic_buffer_resource& resource()
+    {
+        static std::pmr::monotonic_buffer_resource r;
+        return r;
+    }
+};
+
+// ptr must come from AllocationPolicy::create (new T for NewDelete),
+// make_safe takes care of that
 template<class T,
          class CheckingPolicy = CheckForNull<T>,
-         class FallbackPolicy = ThrowException<T> >
+         class FallbackPolicy = ThrowException<T>,
+         class AllocationPolicy = NewDelete<T> >
 class SafePtr
 {
 public:
     SafePtr(T* ptr)
         : m_ptr(ptr)
-    {}
+    {
+        validateOnConstruction<CheckingPolicy>(m_ptr, 0);
+    }
+
+    SafePtr(SafePtr&& other) noexcept
+        : m_ptr(other.m_ptr)
+    {
+        other.m_ptr = nullptr;
+    }
+
+    SafePtr& operator=(SafePtr&& other) noexcept
+    {
+        if(this != &other)
+        {
+            AllocationPolicy::destroy(m_ptr);
+            m_ptr = other.m_ptr;
+            other.m_ptr = nullptr;
+        }
+        return *this;
+    }
+
+    SafePtr(const SafePtr&) = delete;
+    SafePtr& operator=(const SafePtr&) = delete;
 
     ~SafePtr()
     {
-        delete m_ptr;
+        AllocationPolicy::destroy(m_ptr);
         m_ptr = nullptr;
     }
 
+    void reset(T* ptr)
+    {
+        validateOnConstruction<CheckingPolicy>(ptr, 0);
+        AllocationPolicy::destroy(m_ptr);
+        m_ptr = ptr;
+    }
+
     T& operator*()
     {
         return *getSafePtr(m_ptr);
@@ -735,6 +1111,28 @@ public:
         return getSafePtr(m_ptr);
     }
 private:
+    template<class Policy>
+    static auto validateOnConstruction(T*& ptr, int)
+    -> decltype(Policy::isValidOnConstruction(ptr), void())
+    {
+        if(!Policy::isValidOnConstruction(ptr))
+        {
+            try
+            {
+                FallbackPolicy::apply(ptr);
+            }
+            catch(...)
+            {
+                AllocationPolicy::destroy(ptr);
+                throw;
+            }
+        }
+    }
+
+    template<class Policy>
+    static void validateOnConstruction(T*&, long)
+    {}
+
     static T* getSafePtr(T*& ptr)
     {
         if(!CheckingPolicy::isValid(ptr))
@@ -747,6 +1145,17 @@ private:
     T* m_ptr;
 };
 
+template<class T,
+         class CheckingPolicy = CheckForNull<T>,
+         class FallbackPolicy = ThrowException<T>,
+         class AllocationPolicy = NewDelete<T>,
+         class... Args>
+SafePtr<T, CheckingPolicy, FallbackPolicy, AllocationPolicy> make_safe(Args&&... args)
+{
+    return SafePtr<T, CheckingPolicy, FallbackPolicy, AllocationPolicy>(
+               AllocationPolicy::create(std::forward<Args>(args)...));
+}
+
 TEST_CASE("SafePtr operator* forwarded to ptr")
 {
     SafePtr<int> sp(new int(179));
@@ -765,6 +1174,115 @@ TEST_CASE("SafePtr with nullptr throws")
     CHECK_THROWS_AS(void(sp->size() == 6), std::runtime_error);
 }
 
+#include <random>
+
+TEST_CASE("SafePtr checked on construction")
+{
+    using Checked = SafePtr<std::string, CheckOnConstruction<std::string> >;
+    SECTION("valid ptr is forwarded")
+    {
+        Checked sp(new std::string("string"));
+        CHECK(sp->size() == 6);
+    }
+    SECTION("nullptr throws on construction")
+    {
+        CHECK_THROWS_AS(Checked(nullptr), std::runtime_error);
+    }
+    SECTION("reset checks the new ptr and keeps the old one on failure")
+    {
+        Checked sp(new std::string("string"));
+        CHECK_THROWS_AS(sp.reset(nullptr), std::runtime_error);
+        CHECK(sp->size() == 6);
+        sp.reset(new std::string("other string"));
+        CHECK(sp->size() == 12);
+    }
+    SECTION("AssumeValid never checks")
+    {
+        SafePtr<int, AssumeValid<int> > sp(new int(179));
+        CHECK((*sp) == 179);
+    }
+    SECTION("CheckOnceInRelease keeps checking every dereference in debug builds")
+    {
+#ifdef NDEBUG
+        static_assert(
+            std::is_same<CheckOnceInRelease<int>, CheckOnConstruction<int> >::value, "");
+#else
+        static_assert(
+            std::is_same<CheckOnceInRelease<int>, CheckForNull<int> >::value, "");
+#endif
+    }
+}
+
+TEST_CASE("SafePtr pointer chasing benchmark", "[.][benchmark]")
+{
+    const std::size_t count = 1 << 16;
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::shuffle(order.begin(), order.end(), std::mt19937(count));
+    std::vector<std::size_t> next(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        next[order[i]] = order[(i + 1) % count];
+    }
+    // the release check is a constant, so the loop below is the raw pointer loop
+    static_assert(CheckOnConstruction<std::size_t>::isValid(nullptr), "");
+    std::vector<std::size_t*> raw;
+    std::vector<SafePtr<std::size_t> > checked;
+    std::vector<SafePtr<std::size_t, CheckOnConstruction<std::size_t> > > checkedOnce;
+    raw.reserve(count);
+    checked.reserve(count);
+    checkedOnce.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        raw.emplace_back(new std::size_t(next[i]));
+        checked.emplace_back(new std::size_t(next[i]));
+        checkedOnce.emplace_back(new std::size_t(next[i]));
+    }
+    BENCHMARK("raw pointer")
+    {
+        std::size_t i = 0;
+        for(std::size_t n = 0; n < count; ++n)
+        {
+            i = *raw[i];
+        }
+        return i;
+    };
+    BENCHMARK("SafePtr checked on every dereference")
+    {
+        std::size_t i = 0;
+        for(std::size_t n = 0; n < count; ++n)
+        {
+            i = *checked[i];
+        }
+        return i;
+    };
+    BENCHMARK("SafePtr checked on construction")
+    {
+        std::size_t i = 0;
+        for(std::size_t n = 0; n < count; ++n)
+        {
+            i = *checkedOnce[i];
+        }
+        return i;
+    };
+    for(auto ptr : raw)
+    {
+        delete ptr;
+    }
+}
+
+#include <boost/core/demangle.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <thread>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
 namespace crtp
 {
 template <class T>
@@ -811,6 +1329,11 @@ class Cloneable
 public:
     virtual ~Cloneable() {};
     virtual Cloneable* clone() const = 0;
+    // the copy lives in memory from resource, give it back with destroy(resource)
+    virtual Cloneable* clone(std::pmr::memory_resource& resource) const = 0;
+    virtual void destroy(std::pmr::memory_resource& resource) = 0;
+    // upper bound of bytes a copy needs in a monotonic buffer, including alignment
+    virtual std::size_t cloneFootprint() const = 0;
 };
 
 template <typename Derived>
@@ -821,22 +1344,217 @@ public:
     {
         return new Derived(static_cast<Derived const&>(*this));
     }
+    virtual Cloneable* clone(std::pmr::memory_resource& resource) const
+    {
+        void* memory = resource.allocate(sizeof(Derived), alignof(Derived));
+        try
+        {
+            return new(memory) Derived(static_cast<Derived const&>(*this));
+        }
+        catch(...)
+        {
+            resource.deallocate(memory, sizeof(Derived), alignof(Derived));
+            throw;
+        }
+    }
+    virtual void destroy(std::pmr::memory_resource& resource)
+    {
+        Derived* self = static_cast<Derived*>(this);
+        self->~Derived();
+        resource.deallocate(self, sizeof(Derived), alignof(Derived));
+    }
+    virtual std::size_t cloneFootprint() const
+    {
+        return sizeof(Derived) + alignof(Derived) - 1;
+    }
 };
 
-class IAmCopyCloneable : public CopyCloneable<IAmCopyCloneable>
+// clones every object of range with a single allocation from arena
+// and writes the clones to out, release them with destroy_all,
+// their memory goes away with the arena
+template<class Range, class OutputIt>
+OutputIt clone_all(
+    const Range& range,
+    std::pmr::monotonic_buffer_resource& arena,
+    OutputIt out)
 {
-public:
-    IAmCopyCloneable()
-        : m_value(234)
-    {}
-    virtual ~IAmCopyCloneable() {}
-    int m_value;
-};
+    std::size_t bytes = 0;
+    for(const Cloneable* c : range)
+    {
+        bytes += c->cloneFootprint();
+    }
+    if(!bytes)
+    {
+        return out;
+    }
+    void* block = arena.allocate(bytes, alignof(std::max_align_t));
+    std::pmr::monotonic_buffer_resource clones(
+        block, bytes, std::pmr::null_memory_resource());
+    for(const Cloneable* c : range)
+    {
+        *out++ = c->clone(clones);
+    }
+    return out;
+}
 
-class YouAreCopyCloneable : public CopyCloneable<YouAreCopyCloneable>
+template<class Range>
+void destroy_all(const Range& range)
+{
+    for(Cloneable* c : range)
+    {
+        c->~Cloneable();
+    }
+}
+
+// owns objects derived from Base grouped by their dynamic type,
+// objects of one type are stored contiguously in their own segment
+template<class Base>
+class poly_vector
 {
 public:
-    YouAreCopyCloneable()
+    poly_vector() = default;
+    poly_vector(poly_vector&&) = default;
+    poly_vector& operator=(poly_vector&&) = default;
+
+    poly_vector(const poly_vector& other)
+    {
+        for(const auto& segment : other.m_segments)
+        {
+            m_segments.emplace(segment.first, segment.second->clone());
+        }
+    }
+
+    poly_vector& operator=(const poly_vector& other)
+    {
+        poly_vector copy(other);
+        std::swap(m_segments, copy.m_segments);
+        return *this;
+    }
+
+    template<class Derived>
+    void push_back(const Derived& value)
+    {
+        static_assert(std::is_base_of<Base, Derived>::value, "not derived from Base");
+        assert(typeid(value) == typeid(Derived));
+        mutableSegment<Derived>().push_back(value);
+    }
+
+    std::size_t size() const
+    {
+        std::size_t result = 0;
+        for(const auto& segment : m_segments)
+        {
+            result += segment.second->size();
+        }
+        return result;
+    }
+
+    template<class Derived>
+    const std::vector<Derived>& segment() const
+    {
+        static const std::vector<Derived> empty;
+        const auto found = m_segments.find(typeid(Derived));
+        return found == m_segments.end()
+               ? empty
+               : static_cast<const Segment<Derived>&>(*found->second).m_objects;
+    }
+
+    // visits every object as Base&
+    template<class F>
+    void for_each(F f)
+    {
+        for(auto& segment : m_segments)
+        {
+            const auto stride = segment.second->stride();
+            auto first = reinterpret_cast<char*>(segment.second->first());
+            for(std::size_t i = 0, n = segment.second->size(); i < n; ++i)
+            {
+                f(*reinterpret_cast<Base*>(first + i * stride));
+            }
+        }
+    }
+
+    // visits only the objects of Ds, with their static type
+    template<class... Ds, class F>
+    void visit(F f)
+    {
+        (visitSegment<Ds>(f), ...);
+    }
+private:
+    class AnySegment
+    {
+    public:
+        virtual ~AnySegment() {}
+        virtual std::unique_ptr<AnySegment> clone() const = 0;
+        virtual std::size_t size() const = 0;
+        virtual std::size_t stride() const = 0;
+        virtual Base* first() = 0;
+    };
+
+    template<class Derived>
+    class Segment : public AnySegment
+    {
+    public:
+        virtual std::unique_ptr<AnySegment> clone() const
+        {
+            return std::make_unique<Segment>(*this);
+        }
+        virtual std::size_t size() const
+        {
+            return m_objects.size();
+        }
+        virtual std::size_t stride() const
+        {
+            return sizeof(Derived);
+        }
+        virtual Base* first()
+        {
+            return m_objects.data();
+        }
+        std::vector<Derived> m_objects;
+    };
+
+    template<class Derived>
+    std::vector<Derived>& mutableSegment()
+    {
+        auto& segment = m_segments[typeid(Derived)];
+        if(!segment)
+        {
+            segment = std::make_unique<Segment<Derived> >();
+        }
+        return static_cast<Segment<Derived>&>(*segment).m_objects;
+    }
+
+    template<class Derived, class F>
+    void visitSegment(F& f)
+    {
+        const auto found = m_segments.find(typeid(Derived));
+        if(found != m_segments.end())
+        {
+            for(Derived& d : static_cast<Segment<Derived>&>(*found->second).m_objects)
+            {
+                f(d);
+            }
+        }
+    }
+
+    std::unordered_map<std::type_index, std::unique_ptr<AnySegment> > m_segments;
+};
+
+class IAmCopyCloneable : public CopyCloneable<IAmCopyCloneable>
+{
+public:
+    IAmCopyCloneable()
+        : m_value(234)
+    {}
+    virtual ~IAmCopyCloneable() {}
+    int m_value;
+};
+
+class YouAreCopyCloneable : public CopyCloneable<YouAreCopyCloneable>
+{
+public:
+    YouAreCopyCloneable()
         : m_value(234)
     {}
     virtual ~YouAreCopyCloneable() {}
@@ -880,6 +1598,197 @@ int ObjectCounter<CountMe>::s_created = 0;
 class CountMe : public ObjectCounter<CountMe>
 {
 };
+
+// ObjectCounter plus peak count, bytes and a histogram of lifetimes,
+// bucket i counts objects which lived less than 2^(i+1) nanoseconds,
+// like ObjectCounter not thread safe
+template<class Derived>
+class AllocationProfiler : public ObjectCounter<Derived>
+{
+    using Counter = ObjectCounter<Derived>;
+    using Clock = std::chrono::steady_clock;
+public:
+    static const std::size_t buckets = 48;
+    static int s_peak;
+    static std::array<std::size_t, buckets> s_lifetimes;
+    static int peak()
+    {
+        return s_peak;
+    }
+    static std::size_t bytes()
+    {
+        return std::size_t(Counter::created()) * sizeof(Derived);
+    }
+    static std::size_t aliveBytes()
+    {
+        return std::size_t(Counter::alive()) * sizeof(Derived);
+    }
+    static const std::array<std::size_t, buckets>& lifetimes()
+    {
+        return s_lifetimes;
+    }
+    static void report(std::ostream& os)
+    {
+        os << boost::core::demangle(typeid(Derived).name())
+           << ": alive " << Counter::alive()
+           << ", peak " << peak()
+           << ", created " << Counter::created()
+           << ", bytes " << bytes()
+           << ", alive bytes " << aliveBytes() << '\n';
+        for(std::size_t i = 0; i < buckets; ++i)
+        {
+            if(s_lifetimes[i])
+            {
+                os << "  lifetime < 2^" << (i + 1) << "ns: " << s_lifetimes[i] << '\n';
+            }
+        }
+    }
+    static void reportAtExit(std::ostream& os = std::cerr)
+    {
+        static Reporter reporter(os);
+    }
+    AllocationProfiler()
+        : m_born(Clock::now())
+    {
+        s_peak = std::max(s_peak, Counter::alive());
+    }
+    AllocationProfiler(const AllocationProfiler& other)
+        : Counter(other)
+        , m_born(Clock::now())
+    {
+        s_peak = std::max(s_peak, Counter::alive());
+    }
+    ~AllocationProfiler()
+    {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            Clock::now() - m_born).count();
+        std::size_t bucket = 0;
+        for(auto lived = ns >> 1; lived && bucket + 1 < buckets; lived >>= 1)
+        {
+            ++bucket;
+        }
+        ++s_lifetimes[bucket];
+    }
+private:
+    struct Reporter
+    {
+        explicit Reporter(std::ostream& os)
+            : m_os(os)
+        {}
+        ~Reporter()
+        {
+            report(m_os);
+        }
+        std::ostream& m_os;
+    };
+
+    Clock::time_point m_born;
+};
+template<class Derived>
+int AllocationProfiler<Derived>::s_peak = 0;
+template<class Derived>
+std::array<std::size_t, AllocationProfiler<Derived>::buckets>
+AllocationProfiler<Derived>::s_lifetimes = {};
+
+constexpr std::size_t cacheLineSize = 64;
+
+// same interface as ObjectCounter but safe to use from many threads,
+// every thread counts in its own cache line and reads sum up all shards
+template<class CountMe, std::size_t Shards = 64>
+class ShardedObjectCounter
+{
+public:
+    static int alive()
+    {
+        return sum(&Shard::alive);
+    }
+    static int created()
+    {
+        return sum(&Shard::created);
+    }
+    ShardedObjectCounter()
+    {
+        onCreate();
+    }
+    ShardedObjectCounter(const ShardedObjectCounter&)
+    {
+        onCreate();
+    }
+    ~ShardedObjectCounter()
+    {
+        shard().alive.fetch_sub(1, std::memory_order_relaxed);
+    }
+private:
+    struct alignas(cacheLineSize) Shard
+    {
+        std::atomic<int> alive{0};
+        std::atomic<int> created{0};
+    };
+
+    static Shard s_shards[Shards];
+    static std::atomic<std::size_t> s_threads;
+
+    static void onCreate()
+    {
+        Shard& s = shard();
+        s.alive.fetch_add(1, std::memory_order_relaxed);
+        s.created.fetch_add(1, std::memory_order_relaxed);
+    }
+    static Shard& shard()
+    {
+        thread_local const std::size_t index = s_threads++ % Shards;
+        return s_shards[index];
+    }
+    static int sum(std::atomic<int> Shard::* counter)
+    {
+        int total = 0;
+        for(const Shard& s : s_shards)
+        {
+            total += (s.*counter).load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+};
+template<class CountMe, std::size_t Shards>
+typename ShardedObjectCounter<CountMe, Shards>::Shard
+ShardedObjectCounter<CountMe, Shards>::s_shards[Shards];
+template<class CountMe, std::size_t Shards>
+std::atomic<std::size_t> ShardedObjectCounter<CountMe, Shards>::s_threads{0};
+
+// one atomic per counter shared by all threads
+template<class CountMe>
+class AtomicObjectCounter
+{
+public:
+    static std::atomic<int> s_alive;
+    static std::atomic<int> s_created;
+    static int alive()
+    {
+        return s_alive;
+    }
+    static int created()
+    {
+        return s_created;
+    }
+    AtomicObjectCounter()
+    {
+        ++s_alive;
+        ++s_created;
+    }
+    AtomicObjectCounter(const AtomicObjectCounter&)
+    {
+        ++s_alive;
+        ++s_created;
+    }
+    ~AtomicObjectCounter()
+    {
+        --s_alive;
+    }
+};
+template<class CountMe>
+std::atomic<int> AtomicObjectCounter<CountMe>::s_alive{0};
+template<class CountMe>
+std::atomic<int> AtomicObjectCounter<CountMe>::s_created{0};
 }
 
 TEST_CASE("crtp")
@@ -892,222 +1801,2413 @@ TEST_CASE("crtp")
     CHECK(Derived::s_staticImplCalled);
 }
 
-TEST_CASE("crtp-object-counter")
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
+namespace execution
 {
-    using namespace crtp;
-    CHECK(CountMe::created() == 0);
-    CHECK(CountMe::alive() == 0);
+struct sequenced_policy
+{};
+
+struct parallel_policy
+{
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+constexpr sequenced_policy seq{};
+const parallel_policy par{};
+
+// a fixed number of workers running submitted tasks in order
+class thread_pool
+{
+public:
+    explicit thread_pool(unsigned threads)
     {
-        CountMe countMe1;
-        CHECK(CountMe::created() == 1);
-        CHECK(CountMe::alive() == 1);
+        for(unsigned i = 0; i < threads; ++i)
         {
-            CountMe countMe2 = countMe1;
-            CHECK(CountMe::created() == 2);
-            CHECK(CountMe::alive() == 2);
+            m_workers.emplace_back([this] { work(); });
         }
-        CHECK(CountMe::created() == 2);
-        CHECK(CountMe::alive() == 1);
     }
-    CHECK(CountMe::created() == 2);
-    CHECK(CountMe::alive() == 0);
-}
 
-#include <boost/polymorphic_cast.hpp>
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
 
-TEST_CASE("cloneable")
-{
-    using namespace crtp;
+    ~thread_pool()
     {
-        IAmCopyCloneable one;
-        Cloneable* clone = one.clone();
-        IAmCopyCloneable* iAmClone =
-            boost::polymorphic_downcast<IAmCopyCloneable*>(clone);
-        CHECK(one.m_value == iAmClone->m_value);
-        delete clone;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeUp.notify_all();
+        for(auto& worker : m_workers)
+        {
+            worker.join();
+        }
     }
+
+    template<class F>
+    std::future<void> submit(F f)
     {
-        YouAreCopyCloneable one;
-        Cloneable* clone = one.clone();
-        YouAreCopyCloneable* iAmClone =
-            boost::polymorphic_downcast<YouAreCopyCloneable*>(clone);
-        delete clone;
+        std::packaged_task<void()> task(std::move(f));
+        auto result = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_wakeUp.notify_one();
+        return result;
     }
-}
-
-namespace My
-{
-template<class T>
-struct is_array
-    : std::false_type
-{};
 
-template<class T>
-struct is_array<T[]>
-    : std::true_type
-{};
+    static thread_pool& shared()
+    {
+        static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
 
-template<class T, std::size_t N>
-struct is_array<T[N]>
-    : std::true_type
-{};
-}
+    // true on the workers of every pool
+    static bool onWorker()
+    {
+        return workerFlag();
+    }
+private:
+    static bool& workerFlag()
+    {
+        thread_local bool isWorker = false;
+        return isWorker;
+    }
 
-TEST_CASE("is_array")
-{
-    class A {};
-    BOOST_MPL_ASSERT_NOT((My::is_array<A>));
-    BOOST_MPL_ASSERT((My::is_array<A[]>));
-    BOOST_MPL_ASSERT((My::is_array<A[3]>));
-    BOOST_MPL_ASSERT_NOT((My::is_array<float>));
-    BOOST_MPL_ASSERT_NOT((My::is_array<int>));
-    BOOST_MPL_ASSERT((My::is_array<int[]>));
-    BOOST_MPL_ASSERT((My::is_array<int[3]>));
-}
+    void work()
+    {
+        workerFlag() = true;
+        for(;;)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeUp.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if(m_tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
 
-#include <boost/core/enable_if.hpp>
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::deque<std::packaged_task<void()> > m_tasks;
+    std::vector<std::thread> m_workers;
+    bool m_stop = false;
+};
 
-namespace My
-{
-namespace v1
+// calls f(first, last) for one chunk of [0, count) per thread,
+// the chunks run on the shared pool, the calling thread takes the last one,
+// nested calls from a pool task run inline instead of waiting for tasks
+// queued behind the waiting one
+template<class F>
+void parallel_for(const parallel_policy& policy, std::size_t count, F f)
 {
-template<class Container>
-typename boost::enable_if<is_array<Container> >::type
-copy_n(
-    const Container&
-    source, Container& target,
-    std::size_t count)
+    const std::size_t chunks = std::min<std::size_t>(policy.threads, count);
+    if(chunks <= 1 || thread_pool::onWorker())
+    {
+        f(std::size_t{0}, count);
+        return;
+    }
+    const std::size_t chunkSize = (count + chunks - 1) / chunks;
+    std::vector<std::future<void> > workers;
+    std::size_t first = 0;
+    for(; first + chunkSize < count; first += chunkSize)
+    {
+        workers.push_back(thread_pool::shared().submit(
+                              [f, first, chunkSize] { f(first, first + chunkSize); }));
+    }
+    f(first, count);
+    for(auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+}
+
+namespace crtp
 {
-    using value_type = decltype(*std::begin(source));
-    std::memcpy(target, source, sizeof(value_type) * count);
+// one vector per CRTP derived type, interface() runs type by type
+// so every loop calls the implementation without any indirection
+template<class... Ts>
+class crtp_batch
+{
+    static_assert(
+        (std::is_base_of<Base<Ts>, Ts>::value && ...),
+        "every type has to derive from crtp::Base<type>");
+public:
+    template<class T>
+    void push_back(const T& value)
+    {
+        objects<T>().push_back(value);
+    }
+
+    template<class T>
+    std::vector<T>& objects()
+    {
+        return std::get<std::vector<T> >(m_objects);
+    }
+
+    std::size_t size() const
+    {
+        return (std::get<std::vector<Ts> >(m_objects).size() + ...);
+    }
+
+    void interface(execution::sequenced_policy = execution::seq)
+    {
+        (run(std::get<std::vector<Ts> >(m_objects)), ...);
+    }
+
+    void interface(const execution::parallel_policy& policy)
+    {
+        (execution::parallel_for(
+             policy,
+             std::get<std::vector<Ts> >(m_objects).size(),
+             [this](std::size_t first, std::size_t last)
+        {
+            run(std::get<std::vector<Ts> >(m_objects), first, last);
+        }), ...);
+    }
+private:
+    template<class T>
+    static void run(std::vector<T>& objects)
+    {
+        run(objects, 0, objects.size());
+    }
+
+    template<class T>
+    static void run(std::vector<T>& objects, std::size_t first, std::size_t last)
+    {
+        for(; first != last; ++first)
+        {
+            objects[first].interface();
+        }
+    }
+
+    std::tuple<std::vector<Ts>...> m_objects;
+};
 }
-template<class Container>
-typename boost::disable_if<is_array<Container> >::type
-copy_n(
-    const Container& source,
-    Container& target,
-    std::size_t count)
+
+namespace
 {
-    auto&& b(std::begin(source));
-    auto&& e(std::next(b, count));
-    for(; b != e; ++b)
+class Stepper : public crtp::Base<Stepper>
+{
+public:
+    int m_steps = 0;
+    void implementation()
     {
-        target.push_back(*b);
+        ++m_steps;
+    }
+};
+}
+
+TEST_CASE("crtp-batch")
+{
+    using namespace crtp;
+    crtp_batch<Derived, Stepper> batch;
+    for(int i = 0; i < 1000; ++i)
+    {
+        batch.push_back(Derived());
+        batch.push_back(Stepper());
+    }
+    CHECK(batch.size() == 2000);
+    SECTION("sequenced")
+    {
+        batch.interface();
+        CHECK(std::all_of(
+                  batch.objects<Derived>().begin(), batch.objects<Derived>().end(),
+                  [](const Derived& d) { return d.m_memberImplCalled; }));
+        CHECK(batch.objects<Stepper>()[999].m_steps == 1);
+    }
+    SECTION("parallel")
+    {
+        execution::parallel_policy policy;
+        policy.threads = 4;
+        batch.interface(policy);
+        batch.interface(policy);
+        CHECK(std::all_of(
+                  batch.objects<Stepper>().begin(), batch.objects<Stepper>().end(),
+                  [](const Stepper& s) { return s.m_steps == 2; }));
     }
 }
+
+TEST_CASE("parallel_for")
+{
+    execution::parallel_policy policy;
+    policy.threads = 4;
+    SECTION("covers every index once")
+    {
+        std::vector<int> hits(1001);
+        execution::parallel_for(policy, hits.size(), [&](std::size_t first, std::size_t last)
+        {
+            for(; first != last; ++first)
+            {
+                ++hits[first];
+            }
+        });
+        CHECK(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+    }
+    SECTION("nested calls do not wait on each other")
+    {
+        std::atomic<int> inner{0};
+        execution::parallel_for(policy, 8, [&](std::size_t first, std::size_t last)
+        {
+            for(; first != last; ++first)
+            {
+                execution::parallel_for(policy, 8, [&](std::size_t f, std::size_t l)
+                {
+                    inner += static_cast<int>(l - f);
+                });
+            }
+        });
+        CHECK(inner == 64);
+    }
 }
-namespace v2
+
+TEST_CASE("crtp-object-counter")
 {
-template<class Container>
-void copy_n(
-    const Container& source,
-    Container& target,
-    std::size_t count,
-    typename boost::enable_if<is_array<Container> >::type* = nullptr)
+    using namespace crtp;
+    CHECK(CountMe::created() == 0);
+    CHECK(CountMe::alive() == 0);
+    {
+        CountMe countMe1;
+        CHECK(CountMe::created() == 1);
+        CHECK(CountMe::alive() == 1);
+        {
+            CountMe countMe2 = countMe1;
+            CHECK(CountMe::created() == 2);
+            CHECK(CountMe::alive() == 2);
+        }
+        CHECK(CountMe::created() == 2);
+        CHECK(CountMe::alive() == 1);
+    }
+    CHECK(CountMe::created() == 2);
+    CHECK(CountMe::alive() == 0);
+}
+
+namespace
 {
-    using value_type = decltype(*std::begin(source));
-    std::memcpy(target, source, sizeof(value_type) * count);
+// creates and destroys objects instances of Counted, every second one a copy
+template<class Counted>
+void createAndDestroy(int objects)
+{
+    for(int i = 0; i < objects / 2; ++i)
+    {
+        Counted counted;
+        Counted copy = counted;
+    }
 }
-template<class Container>
-void copy_n(
-    const Container& source,
-    Container& target,
-    std::size_t count,
-    typename boost::disable_if<is_array<Container> >::type* = nullptr)
+
+// the pool is started by the caller, so only the counting is measured
+template<class Counted>
+void createAndDestroyConcurrently(execution::thread_pool& pool, int threads, int objectsPerThread)
 {
-    auto&& b(std::begin(source));
-    auto&& e(std::next(b, count));
-    for(; b != e; ++b)
+    std::vector<std::future<void> > workers;
+    workers.reserve(threads);
+    for(int t = 0; t < threads; ++t)
     {
-        target.push_back(*b);
+        workers.push_back(pool.submit([objectsPerThread]
+        {
+            createAndDestroy<Counted>(objectsPerThread);
+        }));
     }
+    for(auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+class ShardedCountMe : public crtp::ShardedObjectCounter<ShardedCountMe>
+{
+};
+
+class AtomicCountMe : public crtp::AtomicObjectCounter<AtomicCountMe>
+{
+};
 }
+
+TEST_CASE("crtp-sharded-object-counter")
+{
+    CHECK(ShardedCountMe::created() == 0);
+    CHECK(ShardedCountMe::alive() == 0);
+    {
+        ShardedCountMe countMe1;
+        ShardedCountMe countMe2 = countMe1;
+        CHECK(ShardedCountMe::created() == 2);
+        CHECK(ShardedCountMe::alive() == 2);
+    }
+    CHECK(ShardedCountMe::alive() == 0);
+    const int threads = 8;
+    const int objectsPerThread = 10000;
+    execution::thread_pool pool(threads);
+    createAndDestroyConcurrently<ShardedCountMe>(pool, threads, objectsPerThread);
+    CHECK(ShardedCountMe::created() == 2 + threads * objectsPerThread);
+    CHECK(ShardedCountMe::alive() == 0);
 }
-namespace v3
+
+TEST_CASE("crtp-object-counter benchmark", "[.][benchmark]")
+{
+    const int threads = std::max(2u, std::thread::hardware_concurrency());
+    const int objectsPerThread = 100000;
+    execution::thread_pool pool(threads);
+    BENCHMARK("std::atomic<int> counter")
+    {
+        createAndDestroyConcurrently<AtomicCountMe>(pool, threads, objectsPerThread);
+        return AtomicCountMe::created();
+    };
+    BENCHMARK("sharded counter")
+    {
+        createAndDestroyConcurrently<ShardedCountMe>(pool, threads, objectsPerThread);
+        return ShardedCountMe::created();
+    };
+}
+
+namespace
+{
+class Profiled : public crtp::AllocationProfiler<Profiled>
+{
+    char m_payload[40];
+};
+}
+
+TEST_CASE("crtp-allocation-profiler")
+{
+    CHECK(Profiled::created() == 0);
+    {
+        std::vector<Profiled> profiled(3);
+        Profiled copy = profiled.front();
+        CHECK(Profiled::alive() == 4);
+        CHECK(Profiled::aliveBytes() == 4 * sizeof(Profiled));
+    }
+    {
+        Profiled one;
+    }
+    CHECK(Profiled::alive() == 0);
+    CHECK(Profiled::created() == 5);
+    CHECK(Profiled::peak() == 4);
+    CHECK(Profiled::bytes() == 5 * sizeof(Profiled));
+    const auto& lifetimes = Profiled::lifetimes();
+    CHECK(std::accumulate(lifetimes.begin(), lifetimes.end(), std::size_t{0}) == 5);
+    std::ostringstream report;
+    Profiled::report(report);
+    CHECK(report.str().find("Profiled: alive 0, peak 4, created 5") != std::string::npos);
+}
+
+#include <boost/polymorphic_cast.hpp>
+
+TEST_CASE("cloneable")
+{
+    using namespace crtp;
+    {
+        IAmCopyCloneable one;
+        Cloneable* clone = one.clone();
+        IAmCopyCloneable* iAmClone =
+            boost::polymorphic_downcast<IAmCopyCloneable*>(clone);
+        CHECK(one.m_value == iAmClone->m_value);
+        delete clone;
+    }
+    {
+        YouAreCopyCloneable one;
+        Cloneable* clone = one.clone();
+        YouAreCopyCloneable* iAmClone =
+            boost::polymorphic_downcast<YouAreCopyCloneable*>(clone);
+        delete clone;
+    }
+}
+
+namespace
+{
+// counts the allocations which reach the upstream resource
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+}
+
+TEST_CASE("cloneable into memory resource")
+{
+    using namespace crtp;
+    SECTION("single clone")
+    {
+        CountingResource resource;
+        IAmCopyCloneable one;
+        one.m_value = 179;
+        Cloneable* clone = one.clone(resource);
+        CHECK(resource.allocations == 1);
+        CHECK(boost::polymorphic_downcast<IAmCopyCloneable*>(clone)->m_value == 179);
+        clone->destroy(resource);
+    }
+    SECTION("clone_all")
+    {
+        std::vector<IAmCopyCloneable> ones(500);
+        std::vector<YouAreCopyCloneable> yous(500);
+        std::vector<Cloneable*> scene;
+        for(std::size_t i = 0; i < ones.size(); ++i)
+        {
+            ones[i].m_value = int(i);
+            yous[i].m_value = -int(i);
+            scene.push_back(&ones[i]);
+            scene.push_back(&yous[i]);
+        }
+        CountingResource upstream;
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        std::vector<Cloneable*> clones;
+        clones.reserve(scene.size());
+        clone_all(scene, arena, std::back_inserter(clones));
+        CHECK(upstream.allocations == 1);
+        REQUIRE(clones.size() == scene.size());
+        CHECK(boost::polymorphic_downcast<IAmCopyCloneable*>(clones[20])->m_value == 10);
+        CHECK(boost::polymorphic_downcast<YouAreCopyCloneable*>(clones[21])->m_value == -10);
+        destroy_all(clones);
+    }
+}
+
+TEST_CASE("poly_vector of cloneables")
+{
+    using namespace crtp;
+    poly_vector<Cloneable> objects;
+    for(int i = 0; i < 10; ++i)
+    {
+        IAmCopyCloneable one;
+        one.m_value = i;
+        YouAreCopyCloneable you;
+        you.m_value = -i;
+        objects.push_back(one);
+        objects.push_back(you);
+    }
+    CHECK(objects.size() == 20);
+    const auto& ones = objects.segment<IAmCopyCloneable>();
+    REQUIRE(ones.size() == 10);
+    CHECK(&ones[9] == &ones[0] + 9);
+    SECTION("visit as base")
+    {
+        std::size_t footprint = 0;
+        objects.for_each([&footprint](Cloneable& c)
+        {
+            footprint += c.cloneFootprint();
+        });
+        CHECK(footprint == 10 * IAmCopyCloneable().cloneFootprint()
+                         + 10 * YouAreCopyCloneable().cloneFootprint());
+    }
+    SECTION("visit with static types")
+    {
+        int sum = 0;
+        objects.visit<IAmCopyCloneable>([&sum](IAmCopyCloneable& c)
+        {
+            sum += c.m_value;
+        });
+        CHECK(sum == 45);
+    }
+    SECTION("copies are independent")
+    {
+        poly_vector<Cloneable> copy = objects;
+        objects.visit<IAmCopyCloneable, YouAreCopyCloneable>([](auto& c)
+        {
+            c.m_value = 0;
+        });
+        CHECK(copy.size() == 20);
+        CHECK(copy.segment<YouAreCopyCloneable>()[9].m_value == -9);
+        CHECK(objects.segment<YouAreCopyCloneable>()[9].m_value == 0);
+    }
+}
+
+TEST_CASE("poly_vector benchmark", "[.][benchmark]")
+{
+    using namespace crtp;
+    const int count = 100000;
+    std::vector<std::unique_ptr<Cloneable> > pointers;
+    poly_vector<Cloneable> objects;
+    std::mt19937 gen(count);
+    for(int i = 0; i < count; ++i)
+    {
+        if(gen() % 2)
+        {
+            pointers.push_back(std::make_unique<IAmCopyCloneable>());
+            objects.push_back(IAmCopyCloneable());
+        }
+        else
+        {
+            pointers.push_back(std::make_unique<YouAreCopyCloneable>());
+            objects.push_back(YouAreCopyCloneable());
+        }
+    }
+    BENCHMARK("vector<unique_ptr<Cloneable>>")
+    {
+        std::size_t footprint = 0;
+        for(const auto& c : pointers)
+        {
+            footprint += c->cloneFootprint();
+        }
+        return footprint;
+    };
+    BENCHMARK("poly_vector visited as base")
+    {
+        std::size_t footprint = 0;
+        objects.for_each([&footprint](Cloneable& c)
+        {
+            footprint += c.cloneFootprint();
+        });
+        return footprint;
+    };
+    BENCHMARK("poly_vector visited with static types")
+    {
+        std::size_t footprint = 0;
+        objects.visit<IAmCopyCloneable, YouAreCopyCloneable>([&footprint](auto& c)
+        {
+            using Derived = std::decay_t<decltype(c)>;
+            footprint += c.Derived::cloneFootprint();
+        });
+        return footprint;
+    };
+}
+
+namespace My
+{
+template<class T>
+struct is_array
+    : std::false_type
+{};
+
+template<class T>
+struct is_array<T[]>
+    : std::true_type
+{};
+
+template<class T, std::size_t N>
+struct is_array<T[N]>
+    : std::true_type
+{};
+}
+
+TEST_CASE("is_array")
+{
+    class A {};
+    BOOST_MPL_ASSERT_NOT((My::is_array<A>));
+    BOOST_MPL_ASSERT((My::is_array<A[]>));
+    BOOST_MPL_ASSERT((My::is_array<A[3]>));
+    BOOST_MPL_ASSERT_NOT((My::is_array<float>));
+    BOOST_MPL_ASSERT_NOT((My::is_array<int>));
+    BOOST_MPL_ASSERT((My::is_array<int[]>));
+    BOOST_MPL_ASSERT((My::is_array<int[3]>));
+}
+
+#include <boost/core/enable_if.hpp>
+
+namespace My
+{
+namespace v1
+{
+template<class Container>
+typename boost::enable_if<is_array<Container> >::type
+copy_n(
+    const Container&
+    source, Container& target,
+    std::size_t count)
+{
+    using value_type = decltype(*std::begin(source));
+    std::memcpy(target, source, sizeof(value_type) * count);
+}
+template<class Container>
+typename boost::disable_if<is_array<Container> >::type
+copy_n(
+    const Container& source,
+    Container& target,
+    std::size_t count)
+{
+    auto&& b(std::begin(source));
+    auto&& e(std::next(b, count));
+    for(; b != e; ++b)
+    {
+        target.push_back(*b);
+    }
+}
+}
+namespace v2
+{
+template<class Container>
+void copy_n(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    typename boost::enable_if<is_array<Container> >::type* = nullptr)
+{
+    using value_type = decltype(*std::begin(source));
+    std::memcpy(target, source, sizeof(value_type) * count);
+}
+template<class Container>
+void copy_n(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    typename boost::disable_if<is_array<Container> >::type* = nullptr)
+{
+    auto&& b(std::begin(source));
+    auto&& e(std::next(b, count));
+    for(; b != e; ++b)
+    {
+        target.push_back(*b);
+    }
+}
+}
+namespace v3
+{
+template<class Container>
+void copy_n_impl(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    std::true_type)
+{
+    using value_type = decltype(*std::begin(source));
+    std::memcpy(target, source, sizeof(value_type) * count);
+}
+template<class Container>
+void copy_n_impl(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    std::false_type)
+{
+    auto&& b(std::begin(source));
+    auto&& e(std::next(b, count));
+    for(; b != e; ++b)
+    {
+        target.push_back(*b);
+    }
+}
+template<class Container>
+void copy_n(const Container& source, Container& target, std::size_t count)
+{
+    typedef typename is_array<Container>::type maybe_array;
+    copy_n_impl(source, target, count, maybe_array());
+}
+}
+}
+
+TEST_CASE("copy_n for containers")
+{
+    SECTION("container")
+    {
+        std::list<int> a = {1, 2, 3, 4, 5};
+        std::list<int> b;
+        My::v1::copy_n(a, b, 5);
+        CHECK(a == b);
+    }
+    SECTION("array")
+    {
+        int a[] = {1, 2, 3, 4, 5};
+        int b[5];
+        My::v1::copy_n(a, b, 5);
+        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+    }
+    SECTION("container")
+    {
+        std::list<int> a = {1, 2, 3, 4, 5};
+        std::list<int> b;
+        My::v2::copy_n(a, b, 5);
+        CHECK(a == b);
+    }
+    SECTION("array")
+    {
+        int a[] = {1, 2, 3, 4, 5};
+        int b[5];
+        My::v2::copy_n(a, b, 5);
+        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+    }
+    SECTION("container")
+    {
+        std::list<int> a = {1, 2, 3, 4, 5};
+        std::list<int> b;
+        My::v3::copy_n(a, b, 5);
+        CHECK(a == b);
+    }
+    SECTION("array")
+    {
+        int a[] = {1, 2, 3, 4, 5};
+        int b[5];
+        My::v3::copy_n(a, b, 5);
+        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+    }
+}
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace My
+{
+template<class Container>
+using value_type_of = typename std::decay<
+    decltype(*std::begin(std::declval<Container&>()))>::type;
+
+// elements are laid out in one block of memory
+template<class Container>
+struct is_contiguous
+    : is_array<Container>
+{};
+
+template<class T, class Allocator>
+struct is_contiguous<std::vector<T, Allocator> >
+    : std::true_type
+{};
+
+template<class Allocator>
+struct is_contiguous<std::vector<bool, Allocator> >
+    : std::false_type
+{};
+
+template<class T, std::size_t N>
+struct is_contiguous<std::array<T, N> >
+    : std::true_type
+{};
+
+template<class Char, class Traits, class Allocator>
+struct is_contiguous<std::basic_string<Char, Traits, Allocator> >
+    : std::true_type
+{};
+
+// elements live in a sequence of contiguous blocks
+template<class Container>
+struct is_segmented
+    : std::false_type
+{};
+
+template<class T, class Allocator>
+struct is_segmented<std::deque<T, Allocator> >
+    : std::true_type
+{};
+
+template<class Container, class = void>
+struct is_reservable
+    : std::false_type
+{};
+
+template<class Container>
+struct is_reservable<Container, std::void_t<
+    decltype(std::declval<Container&>().reserve(std::size_t{}))> >
+    : std::true_type
+{};
+
+template<class Container, class = void>
+struct has_push_back
+    : std::false_type
+{};
+
+template<class Container>
+struct has_push_back<Container, std::void_t<
+    decltype(std::declval<Container&>().push_back(
+        std::declval<const value_type_of<Container>&>()))> >
+    : std::true_type
+{};
+
+namespace v4
+{
+struct memcpy_tag {};
+struct range_insert_tag {};
+struct element_tag {};
+struct streaming_tag {};
+
+// copies beyond this many bytes bypass the cache
+constexpr std::size_t streamingThreshold = std::size_t(16) << 20;
+
+inline void memcpy_void(void* target, const void* source, std::size_t bytes)
+{
+    std::memcpy(target, source, bytes);
+}
+
+// memcpy with non-temporal stores, the target is not pulled into the cache
+// and does not evict the working set of other cores
+inline void stream_copy(void* target, const void* source, std::size_t bytes)
+{
+#if defined(__SSE2__)
+    char* t = static_cast<char*>(target);
+    const char* s = static_cast<const char*>(source);
+    const std::size_t head = std::min(
+        bytes, (16 - reinterpret_cast<std::uintptr_t>(t) % 16) % 16);
+    std::memcpy(t, s, head);
+    t += head;
+    s += head;
+    bytes -= head;
+    for(; bytes >= 64; bytes -= 64, t += 64, s += 64)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(t), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(t + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(t + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(t + 48), d);
+    }
+    _mm_sfence();
+    std::memcpy(t, s, bytes);
+#else
+    std::memcpy(target, source, bytes);
+#endif
+}
+
+// fixed size contiguous containers of trivially copyable types are memcpy'd,
+// growable contiguous and segmented containers get one range insert,
+// everything else is copied element by element
+template<class Container>
+using copy_strategy = typename std::conditional <
+    is_contiguous<Container>::value
+    && !is_reservable<Container>::value
+    && std::is_trivially_copyable<value_type_of<Container> >::value,
+    memcpy_tag,
+    typename std::conditional <
+    is_reservable<Container>::value || is_segmented<Container>::value,
+    range_insert_tag,
+    element_tag
+    >::type
+    >::type;
+
+template<class Container>
+void copy_n_impl(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    memcpy_tag)
+{
+    const auto bytes = sizeof(value_type_of<Container>) * count;
+    if(bytes >= streamingThreshold)
+    {
+        stream_copy(&*std::begin(target), &*std::begin(source), bytes);
+    }
+    else
+    {
+        std::memcpy(&*std::begin(target), &*std::begin(source), bytes);
+    }
+}
+template<class Container>
+void copy_n_impl(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    streaming_tag)
+{
+    static_assert(
+        std::is_same<copy_strategy<Container>, memcpy_tag>::value,
+        "streaming needs a fixed size contiguous container of trivially copyable types");
+    stream_copy(
+        &*std::begin(target),
+        &*std::begin(source),
+        sizeof(value_type_of<Container>) * count);
+}
+template<class Container>
+void copy_n_impl(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    range_insert_tag)
+{
+    // a forward range insert allocates what it needs up front and keeps
+    // the geometric growth of a vector, reserving the exact size would not,
+    // a deque gets its new blocks at once and is filled block by block
+    auto b(std::begin(source));
+    target.insert(std::end(target), b, std::next(b, count));
+}
+template<class Container>
+void copy_n_impl(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    element_tag)
+{
+    auto b(std::begin(source));
+    if constexpr(has_push_back<Container>::value)
+    {
+        for(; count; --count, ++b)
+        {
+            target.push_back(*b);
+        }
+    }
+    else if constexpr(is_contiguous<Container>::value)
+    {
+        std::copy_n(b, count, std::begin(target));
+    }
+    else
+    {
+        // forward_list only appends after its last element
+        auto last = target.before_begin();
+        for(auto it = target.begin(); it != target.end(); ++it)
+        {
+            last = it;
+        }
+        target.insert_after(last, b, std::next(b, count));
+    }
+}
+template<class Container>
+void copy_n(const Container& source, Container& target, std::size_t count)
+{
+    copy_n_impl(source, target, count, copy_strategy<Container>());
+}
+template<class Container>
+void copy_n(const Container& source, Container& target, std::size_t count, streaming_tag tag)
+{
+    copy_n_impl(source, target, count, tag);
+}
+
+// copies below this many bytes stay on the calling thread
+constexpr std::size_t parallelThreshold = std::size_t(4) << 20;
+
+// splits the copy at page boundaries of the target, one chunk per thread
+inline void parallel_copy(
+    void* target,
+    const void* source,
+    std::size_t bytes,
+    const execution::parallel_policy& policy,
+    std::size_t serialThreshold)
+{
+    auto copy = bytes >= streamingThreshold ? &stream_copy : &memcpy_void;
+    if(bytes < serialThreshold || policy.threads < 2)
+    {
+        copy(target, source, bytes);
+        return;
+    }
+    const std::size_t page = 4096;
+    char* t = static_cast<char*>(target);
+    const char* s = static_cast<const char*>(source);
+    const std::size_t head = std::min(
+        bytes, (page - reinterpret_cast<std::uintptr_t>(t) % page) % page);
+    const std::size_t pages = (bytes - head + page - 1) / page;
+    const std::size_t pagesPerChunk = (pages + policy.threads - 1) / policy.threads;
+    auto boundary = [=](std::size_t chunk)
+    {
+        return chunk == 0 ? 0 : std::min(bytes, head + chunk * pagesPerChunk * page);
+    };
+    execution::parallel_for(
+        policy,
+        policy.threads,
+        [=](std::size_t first, std::size_t last)
+    {
+        copy(t + boundary(first), s + boundary(first), boundary(last) - boundary(first));
+    });
+}
+
+// contiguous containers of trivially copyable types only,
+// copies which stay on the calling thread go through the serial copy_n,
+// otherwise a vector is resized first and its new elements are zero filled
+// on the calling thread before the threads overwrite them
+template<class Container>
+void copy_n(
+    const Container& source,
+    Container& target,
+    std::size_t count,
+    const execution::parallel_policy& policy,
+    std::size_t serialThreshold = parallelThreshold)
+{
+    static_assert(
+        is_contiguous<Container>::value
+        && std::is_trivially_copyable<value_type_of<Container> >::value,
+        "parallel copy needs a contiguous container of trivially copyable types");
+    const auto bytes = sizeof(value_type_of<Container>) * count;
+    if(bytes < serialThreshold || policy.threads < 2)
+    {
+        copy_n(source, target, count);
+        return;
+    }
+    auto targetFirst = std::begin(target);
+    if constexpr(is_reservable<Container>::value)
+    {
+        const auto size = target.size();
+        target.resize(size + count);
+        targetFirst = std::next(std::begin(target), size);
+    }
+    parallel_copy(&*targetFirst, &*std::begin(source), bytes, policy, serialThreshold);
+}
+}
+}
+
+TEST_CASE("copy_n strategies")
+{
+    using My::v4::copy_strategy;
+    using My::v4::memcpy_tag;
+    using My::v4::range_insert_tag;
+    using My::v4::element_tag;
+    static_assert(std::is_same<copy_strategy<int[3]>, memcpy_tag>::value, "");
+    static_assert(std::is_same<copy_strategy<std::array<int, 3> >, memcpy_tag>::value, "");
+    static_assert(std::is_same<copy_strategy<std::string[3]>, element_tag>::value, "");
+    static_assert(std::is_same<copy_strategy<std::vector<int> >, range_insert_tag>::value, "");
+    static_assert(std::is_same<copy_strategy<std::deque<int> >, range_insert_tag>::value, "");
+    static_assert(std::is_same<copy_strategy<std::list<int> >, element_tag>::value, "");
+    static_assert(std::is_same<copy_strategy<std::forward_list<int> >, element_tag>::value, "");
+    static_assert(My::is_contiguous<std::vector<int> >::value, "");
+    static_assert(!My::is_contiguous<std::vector<bool> >::value, "");
+    static_assert(!My::is_contiguous<std::deque<int> >::value, "");
+    SECTION("vector")
+    {
+        std::vector<int> a = {1, 2, 3, 4, 5};
+        std::vector<int> b = {0};
+        My::v4::copy_n(a, b, 5);
+        CHECK(b == std::vector<int>({0, 1, 2, 3, 4, 5}));
+    }
+    SECTION("repeated appends grow geometrically")
+    {
+        const std::vector<int> one = {1};
+        std::vector<int> target;
+        int reallocations = 0;
+        for(int i = 0; i < 10000; ++i)
+        {
+            const auto capacity = target.capacity();
+            My::v4::copy_n(one, target, 1);
+            reallocations += target.capacity() != capacity;
+        }
+        CHECK(target.size() == 10000);
+        CHECK(reallocations < 32);
+    }
+    SECTION("deque")
+    {
+        std::deque<int> a = {1, 2, 3, 4, 5};
+        std::deque<int> b;
+        My::v4::copy_n(a, b, 3);
+        CHECK(b == std::deque<int>({1, 2, 3}));
+    }
+    SECTION("deque spanning many blocks")
+    {
+        // used as a ring buffer, so the front does not start a block
+        std::deque<std::uint16_t> a;
+        for(int i = 0; i < 5000; ++i)
+        {
+            a.push_back(static_cast<std::uint16_t>(i));
+        }
+        a.erase(a.begin(), a.begin() + 777);
+        std::deque<std::uint16_t> b = {1, 2, 3};
+        My::v4::copy_n(a, b, 4000);
+        REQUIRE(b.size() == 4003);
+        CHECK(b[2] == 3);
+        CHECK(std::equal(a.begin(), a.begin() + 4000, b.begin() + 3));
+    }
+    SECTION("forward_list")
+    {
+        std::forward_list<int> a = {1, 2, 3, 4, 5};
+        std::forward_list<int> b = {0};
+        My::v4::copy_n(a, b, 5);
+        CHECK(b == std::forward_list<int>({0, 1, 2, 3, 4, 5}));
+    }
+    SECTION("array")
+    {
+        int a[] = {1, 2, 3, 4, 5};
+        int b[5];
+        My::v4::copy_n(a, b, 5);
+        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+    }
+    SECTION("std::array")
+    {
+        std::array<int, 5> a = {{1, 2, 3, 4, 5}};
+        std::array<int, 5> b = {};
+        My::v4::copy_n(a, b, 5);
+        CHECK(a == b);
+    }
+    SECTION("array of strings")
+    {
+        std::string a[] = {"one", "two", "three"};
+        std::string b[3];
+        My::v4::copy_n(a, b, 3);
+        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+    }
+}
+
+TEST_CASE("copy_n streaming")
+{
+    SECTION("unaligned ranges")
+    {
+        std::vector<char> source(1000);
+        std::iota(source.begin(), source.end(), char{0});
+        for(std::size_t offset : {0, 1, 7, 15})
+        {
+            for(std::size_t bytes : {0, 3, 64, 100, 500})
+            {
+                std::vector<char> target(1000, 'x');
+                My::v4::stream_copy(target.data() + offset, source.data() + 1, bytes);
+                CHECK(std::equal(source.begin() + 1, source.begin() + 1 + bytes, target.begin() + offset));
+                CHECK(target[offset + bytes] == 'x');
+            }
+        }
+    }
+    SECTION("streaming tag")
+    {
+        std::array<int, 1000> a;
+        std::iota(a.begin(), a.end(), 0);
+        std::array<int, 1000> b = {};
+        My::v4::copy_n(a, b, 1000, My::v4::streaming_tag());
+        CHECK(a == b);
+    }
+}
+
+TEST_CASE("copy_n parallel")
+{
+    execution::parallel_policy policy;
+    policy.threads = 4;
+    std::vector<int> source(100000);
+    std::iota(source.begin(), source.end(), 0);
+    SECTION("vector is appended")
+    {
+        std::vector<int> target = {-1};
+        My::v4::copy_n(source, target, source.size(), policy, 0);
+        REQUIRE(target.size() == source.size() + 1);
+        CHECK(target[0] == -1);
+        CHECK(std::equal(source.begin(), source.end(), target.begin() + 1));
+    }
+    SECTION("small copies stay serial")
+    {
+        std::vector<int> target;
+        My::v4::copy_n(source, target, 10, policy);
+        CHECK(target == std::vector<int>(source.begin(), source.begin() + 10));
+    }
+    SECTION("one thread appends like the serial copy_n")
+    {
+        execution::parallel_policy serial;
+        serial.threads = 1;
+        std::vector<int> target = {-1};
+        My::v4::copy_n(source, target, source.size(), serial, 0);
+        REQUIRE(target.size() == source.size() + 1);
+        CHECK(std::equal(source.begin(), source.end(), target.begin() + 1));
+    }
+    SECTION("array")
+    {
+        auto a = std::make_unique<std::array<int, 100000> >();
+        auto b = std::make_unique<std::array<int, 100000> >();
+        std::copy(source.begin(), source.end(), a->begin());
+        My::v4::copy_n(*a, *b, a->size(), policy, 0);
+        CHECK(*a == *b);
+    }
+}
+
+namespace
+{
+const std::size_t copyCount = 100000;
+int copySourceArray[copyCount];
+int copyTargetArray[copyCount];
+}
+
+TEST_CASE("copy_n benchmark", "[.][benchmark]")
+{
+    const std::vector<int> vector(copyCount, 179);
+    const std::deque<int> deque(copyCount, 179);
+    const std::list<int> list(copyCount, 179);
+    const std::forward_list<int> forwardList(copyCount, 179);
+    BENCHMARK("v3 vector")
+    {
+        std::vector<int> target;
+        My::v3::copy_n(vector, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v4 vector")
+    {
+        std::vector<int> target;
+        My::v4::copy_n(vector, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v3 deque")
+    {
+        std::deque<int> target;
+        My::v3::copy_n(deque, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v4 deque")
+    {
+        std::deque<int> target;
+        My::v4::copy_n(deque, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v3 list")
+    {
+        std::list<int> target;
+        My::v3::copy_n(list, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v4 list")
+    {
+        std::list<int> target;
+        My::v4::copy_n(list, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v4 forward_list")
+    {
+        std::forward_list<int> target;
+        My::v4::copy_n(forwardList, target, copyCount);
+        return target;
+    };
+    BENCHMARK("v3 array")
+    {
+        My::v3::copy_n(copySourceArray, copyTargetArray, copyCount);
+        return copyTargetArray[0];
+    };
+    BENCHMARK("v4 array")
+    {
+        My::v4::copy_n(copySourceArray, copyTargetArray, copyCount);
+        return copyTargetArray[0];
+    };
+}
+
+TEST_CASE("copy_n streaming benchmark", "[.][benchmark]")
+{
+    // a reader scans its working set while another thread copies
+    // large arrays, streaming stores leave the reader's cache lines alone
+    const std::size_t copyBytes = std::size_t(64) << 20;
+    using Block = std::array<char, copyBytes>;
+    auto source = std::make_unique<Block>();
+    auto target = std::make_unique<Block>();
+    source->fill(1);
+    std::vector<int> workingSet(std::size_t(1) << 19, 1);
+    auto readWhileCopying = [&](auto copy)
+    {
+        std::atomic<bool> done{false};
+        std::thread copier([&]
+        {
+            while(!done)
+            {
+                copy();
+            }
+        });
+        long long sum = 0;
+        for(int pass = 0; pass < 50; ++pass)
+        {
+            sum += std::accumulate(workingSet.begin(), workingSet.end(), 0LL);
+        }
+        done = true;
+        copier.join();
+        return sum;
+    };
+    BENCHMARK("reader while copying with memcpy")
+    {
+        return readWhileCopying([&]
+        {
+            std::memcpy(target->data(), source->data(), copyBytes);
+        });
+    };
+    BENCHMARK("reader while copying with streaming stores")
+    {
+        return readWhileCopying([&]
+        {
+            My::v4::copy_n(*source, *target, copyBytes, My::v4::streaming_tag());
+        });
+    };
+}
+
+TEST_CASE("copy_n parallel benchmark", "[.][benchmark]")
+{
+    const std::size_t count = std::size_t(64) << 20;
+    const std::vector<char> source(count, 1);
+    std::vector<char> target;
+    target.reserve(count);
+    BENCHMARK("serial copy_n")
+    {
+        target.clear();
+        My::v4::copy_n(source, target, count);
+        return target.back();
+    };
+    BENCHMARK("parallel copy_n")
+    {
+        target.clear();
+        My::v4::copy_n(source, target, count, execution::par);
+        return target.back();
+    };
+}
+
+namespace MplMax
+{
+namespace v3
+{
+namespace MaxSize
+{
+namespace runtime
+{
+namespace v4
+{
+// no temporaries and four independent maxima, the loop is bound by loading
+// the size fields instead of waiting on the previous comparison
+template<class Iterator>
+std::string::size_type maxLength(Iterator first, Iterator last)
+{
+    std::string::size_type m0 = 0;
+    std::string::size_type m1 = 0;
+    std::string::size_type m2 = 0;
+    std::string::size_type m3 = 0;
+    for(; last - first >= 4; first += 4)
+    {
+        m0 = std::max(m0, first[0].size());
+        m1 = std::max(m1, first[1].size());
+        m2 = std::max(m2, first[2].size());
+        m3 = std::max(m3, first[3].size());
+    }
+    for(; first != last; ++first)
+    {
+        m0 = std::max(m0, first->size());
+    }
+    return std::max(std::max(m0, m1), std::max(m2, m3));
+}
+
+static auto value(const std::vector<std::string>& strings)
+{
+    return maxLength(std::begin(strings), std::end(strings));
+}
+
+// every thread reduces its own chunk and publishes the result once
+static auto value(
+    const execution::parallel_policy& policy,
+    const std::vector<std::string>& strings)
+{
+    std::atomic<std::string::size_type> result{0};
+    execution::parallel_for(
+        policy,
+        strings.size(),
+        [&](std::size_t first, std::size_t last)
+    {
+        const auto length = maxLength(
+                                std::begin(strings) + first,
+                                std::begin(strings) + last);
+        auto current = result.load(std::memory_order_relaxed);
+        while(current < length
+                && !result.compare_exchange_weak(current, length, std::memory_order_relaxed))
+        {}
+    });
+    return result.load();
+}
+}
+}
+}
+}
+}
+
+TEST_CASE("MaxSize at runtime without temporaries")
+{
+    using namespace std::string_literals;
+    using MplMax::v3::MaxSize::runtime::v4::value;
+
+    CHECK((value({"char"     , "short", "int"  , "long long"})) ==
+          "long long"s.size());
+    CHECK((value({"long long", "int"  , "short", "char"     })) ==
+          "long long"s.size());
+    CHECK((value({"float"    , "double"                     })) ==
+          "double"s.size());
+    CHECK((value({"double"   , "float"                      })) ==
+          "double"s.size());
+    CHECK((value({})) == 0);
+    SECTION("every position and thread count")
+    {
+        std::vector<std::string> strings(37, "ab");
+        for(std::size_t i = 0; i < strings.size(); ++i)
+        {
+            strings[i] = "long long";
+            for(unsigned threads : {1u, 2u, 5u, 64u})
+            {
+                execution::parallel_policy policy;
+                policy.threads = threads;
+                CHECK(value(policy, strings) == "long long"s.size());
+            }
+            CHECK(value(strings) == "long long"s.size());
+            strings[i] = "ab";
+        }
+    }
+}
+
+TEST_CASE("MaxSize at runtime benchmark", "[.][benchmark]")
+{
+    namespace runtime = MplMax::v3::MaxSize::runtime;
+    std::mt19937 generator(179);
+    std::uniform_int_distribution<std::size_t> length(0, 40);
+    std::vector<std::string> strings(std::size_t(4) << 20);
+    for(auto& s : strings)
+    {
+        s.assign(length(generator), 'x');
+    }
+    BENCHMARK("v1")
+    {
+        return runtime::v1::value(strings);
+    };
+    BENCHMARK("v2")
+    {
+        return runtime::v2::value(strings);
+    };
+    BENCHMARK("v3")
+    {
+        return runtime::v3::value(strings);
+    };
+    BENCHMARK("v4")
+    {
+        return runtime::v4::value(strings);
+    };
+    BENCHMARK("v4 parallel")
+    {
+        return runtime::v4::value(execution::par, strings);
+    };
+}
+
+#include <new>
+
+namespace My
+{
+namespace v2
+{
+// holds an object derived from Interface inside its own buffer
+// if it fits into Size bytes, on the heap otherwise,
+// or in memory owned by someone else (see emplaceAt)
+template<class Interface, std::size_t Size = 3 * sizeof(void*)>
+class SmallBuffer
+{
+public:
+    SmallBuffer() = default;
+    SmallBuffer(const SmallBuffer&) = delete;
+    SmallBuffer& operator=(const SmallBuffer&) = delete;
+
+    // Interface has to provide Interface* moveTo(void* buffer)
+    // which move constructs the held object into buffer
+    SmallBuffer(SmallBuffer&& other) noexcept
+    {
+        take(other);
+    }
+
+    SmallBuffer& operator=(SmallBuffer&& other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~SmallBuffer()
+    {
+        reset();
+    }
+
+    template<class Held>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(Held) <= Size
+               && alignof(Held) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible<Held>::value;
+    }
+
+    template<class Held, class... Args>
+    void emplace(Args&&... args)
+    {
+        reset();
+        if constexpr(fitsInline<Held>())
+        {
+            m_held = new(&m_buffer) Held(std::forward<Args>(args)...);
+            m_placement = Inline;
+        }
+        else
+        {
+            m_held = new Held(std::forward<Args>(args)...);
+        }
+    }
+
+    // memory is only used if Held does not fit inline
+    // and has to outlive the held object
+    template<class Held, class... Args>
+    void emplaceAt(void* memory, Args&&... args)
+    {
+        if constexpr(fitsInline<Held>())
+        {
+            emplace<Held>(std::forward<Args>(args)...);
+        }
+        else
+        {
+            reset();
+            m_held = new(memory) Held(std::forward<Args>(args)...);
+            m_placement = External;
+        }
+    }
+
+    void reset()
+    {
+        if(m_placement == OnHeap)
+        {
+            delete m_held;
+        }
+        else
+        {
+            m_held->~Interface();
+        }
+        m_held = nullptr;
+        m_placement = OnHeap;
+    }
+
+    bool isInline() const
+    {
+        return m_placement == Inline;
+    }
+
+    Interface* get() const
+    {
+        return m_held;
+    }
+
+    Interface* operator->() const
+    {
+        return m_held;
+    }
+private:
+    enum Placement
+    {
+        OnHeap,
+        Inline,
+        External
+    };
+
+    void take(SmallBuffer& other)
+    {
+        m_placement = other.m_placement;
+        if(other.m_placement == Inline)
+        {
+            m_held = other.m_held->moveTo(&m_buffer);
+            other.reset();
+        }
+        else
+        {
+            m_held = other.m_held;
+            other.m_held = nullptr;
+            other.m_placement = OnHeap;
+        }
+    }
+
+    typename std::aligned_storage<Size, alignof(std::max_align_t)>::type m_buffer;
+    Interface* m_held = nullptr;
+    Placement m_placement = OnHeap;
+};
+
+template<class T>
+class CheckForNull;
+
+template<class T>
+class ThrowException;
+
+template<class T>
+class Delete;
+
+template<class T>
+class DestroyInPlace;
+
+template<class Policy>
+struct allocation_of;
+
+// a fallback which replaces the object must create it the way the deleter
+// destroys it, policies which do not touch memory combine with anything
+template<class FallbackPolicy, class DeleterPolicy>
+constexpr bool sharesAllocation()
+{
+    using F = typename allocation_of<FallbackPolicy>::type;
+    using D = typename allocation_of<DeleterPolicy>::type;
+    return std::is_void<F>::value || std::is_void<D>::value || std::is_same<F, D>::value;
+}
+
+template<class T>
+class SafePtr
+{
+public:
+    template<class CheckingPolicy, class FallbackPolicy>
+    SafePtr(T* ptr, const CheckingPolicy& c, const FallbackPolicy& f)
+        : SafePtr(ptr, c, f, Delete<T>())
+    {}
+
+    template<class CheckingPolicy, class FallbackPolicy, class AllocationPolicy>
+    SafePtr(T* ptr, const CheckingPolicy& c, const FallbackPolicy& f, const AllocationPolicy& a)
+        : m_ptr(ptr)
+    {
+        static_assert(
+            sharesAllocation<FallbackPolicy, AllocationPolicy>(),
+            "the fallback must allocate the way the deleter frees");
+        m_checker.template emplace<CheckHolder<CheckingPolicy>>(c);
+        m_fallback.template emplace<FallbackHolder<FallbackPolicy>>(f);
+        m_deleter.template emplace<DeleterHolder<AllocationPolicy>>(a);
+    }
+
+    // one block holds the object followed by
+    // every policy holder which does not fit inline
+    template<class CheckingPolicy, class FallbackPolicy, class... Args>
+    static SafePtr make(const CheckingPolicy& c, const FallbackPolicy& f, Args&&... args)
+    {
+        using C = CheckHolder<CheckingPolicy>;
+        using F = FallbackHolder<FallbackPolicy>;
+        using D = DeleterHolder<DestroyInPlace<T> >;
+        // every part starts at a multiple of max_align_t in a block from operator new
+        static_assert(
+            alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+            "over aligned types are not supported");
+        static_assert(
+            fitsBlock<C>() && fitsBlock<F>() && fitsBlock<D>(),
+            "over aligned policies are not supported");
+        static_assert(
+            sharesAllocation<FallbackPolicy, DestroyInPlace<T> >(),
+            "the object lives inside the block, a fallback must not replace it");
+        const std::size_t checkerAt = blockSize<T>();
+        const std::size_t fallbackAt = checkerAt + blockSize<C>();
+        const std::size_t deleterAt = fallbackAt + blockSize<F>();
+        const std::size_t size = deleterAt + blockSize<D>();
+        SafePtr sp;
+        sp.m_block.reset(::operator new(size));
+        char* block = static_cast<char*>(sp.m_block.get());
+        sp.m_checker.template emplaceAt<C>(block + checkerAt, c);
+        sp.m_fallback.template emplaceAt<F>(block + fallbackAt, f);
+        sp.m_deleter.template emplaceAt<D>(block + deleterAt, DestroyInPlace<T>());
+        sp.m_ptr = new(block) T(std::forward<Args>(args)...);
+        return sp;
+    }
+
+    SafePtr(SafePtr&& other) noexcept
+        : m_block(std::move(other.m_block))
+        , m_ptr(other.m_ptr)
+        , m_checker(std::move(other.m_checker))
+        , m_fallback(std::move(other.m_fallback))
+        , m_deleter(std::move(other.m_deleter))
+    {
+        other.m_ptr = nullptr;
+        other.leaveEmpty();
+    }
+
+    SafePtr& operator=(SafePtr&& other) noexcept
+    {
+        if(this != &other)
+        {
+            destroy();
+            m_ptr = other.m_ptr;
+            other.m_ptr = nullptr;
+            m_checker = std::move(other.m_checker);
+            m_fallback = std::move(other.m_fallback);
+            m_deleter = std::move(other.m_deleter);
+            m_block = std::move(other.m_block);
+            other.leaveEmpty();
+        }
+        return *this;
+    }
+
+    SafePtr(const SafePtr&) = delete;
+    SafePtr& operator=(const SafePtr&) = delete;
+
+    ~SafePtr()
+    {
+        destroy();
+    }
+
+    T& operator*()
+    {
+        return *getSafePtr(m_ptr);
+    }
+
+    T* operator->()
+    {
+        return getSafePtr(m_ptr);
+    }
+private:
+    class Check
+    {
+    public:
+        virtual ~Check() {}
+        virtual bool isValid(T const* ptr) const = 0;
+        virtual Check* moveTo(void* buffer) = 0;
+    };
+
+    class Fallback
+    {
+    public:
+        virtual ~Fallback() {}
+        virtual void fallback(T*& ptr) = 0;
+        virtual Fallback* moveTo(void* buffer) = 0;
+    };
+
+    class Deleter
+    {
+    public:
+        virtual ~Deleter() {}
+        virtual void destroy(T* ptr) = 0;
+        virtual Deleter* moveTo(void* buffer) = 0;
+    };
+
+    template<class CheckType>
+    class CheckHolder : public Check
+    {
+    public:
+        CheckHolder(const CheckType& value)
+            : m_held(value)
+        {
+        }
+
+        virtual bool isValid(T const* ptr) const
+        {
+            return m_held(ptr);
+        }
+
+        virtual Check* moveTo(void* buffer)
+        {
+            return new(buffer) CheckHolder(std::move(*this));
+        }
+    private:
+        CheckType m_held;
+    };
+
+    template<class FallbackType>
+    class FallbackHolder : public Fallback
+    {
+    public:
+        FallbackHolder(const FallbackType& value)
+            : m_held(value)
+        {
+        }
+
+        virtual void fallback(T*& ptr)
+        {
+            m_held(ptr);
+        }
+
+        virtual Fallback* moveTo(void* buffer)
+        {
+            return new(buffer) FallbackHolder(std::move(*this));
+        }
+    private:
+        FallbackType m_held;
+    };
+
+    template<class DeleterType>
+    class DeleterHolder : public Deleter
+    {
+    public:
+        DeleterHolder(const DeleterType& value)
+            : m_held(value)
+        {
+        }
+
+        virtual void destroy(T* ptr)
+        {
+            m_held(ptr);
+        }
+
+        virtual Deleter* moveTo(void* buffer)
+        {
+            return new(buffer) DeleterHolder(std::move(*this));
+        }
+    private:
+        DeleterType m_held;
+    };
+
+    struct FreeBlock
+    {
+        void operator()(void* block) const
+        {
+            ::operator delete(block);
+        }
+    };
+
+    SafePtr()
+        : m_ptr(nullptr)
+    {}
+
+    // bytes Held occupies in a make() block, padded to keep the next one aligned,
+    // holders fitting inline take none (all SmallBuffers share one size)
+    template<class Held>
+    static constexpr std::size_t blockSize()
+    {
+        constexpr std::size_t align = alignof(std::max_align_t);
+        if(!std::is_same<Held, T>::value && SmallBuffer<Check>::template fitsInline<Held>())
+        {
+            return 0;
+        }
+        return (sizeof(Held) + align - 1) / align * align;
+    }
+
+    template<class Held>
+    static constexpr bool fitsBlock()
+    {
+        return alignof(Held) <= alignof(std::max_align_t)
+               && alignof(std::max_align_t) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+
+    void destroy()
+    {
+        if(m_ptr)
+        {
+            m_deleter->destroy(m_ptr);
+        }
+        m_ptr = nullptr;
+    }
+
+    // a moved-from SafePtr holds nullptr and throws on dereference,
+    // the stateless default policies fit inline, so this cannot throw
+    void leaveEmpty()
+    {
+        using C = CheckHolder<CheckForNull<T> >;
+        using F = FallbackHolder<ThrowException<T> >;
+        static_assert(
+            SmallBuffer<Check>::template fitsInline<C>()
+            && SmallBuffer<Fallback>::template fitsInline<F>(), "");
+        m_checker.template emplace<C>(CheckForNull<T>());
+        m_fallback.template emplace<F>(ThrowException<T>());
+    }
+
+    T* getSafePtr(T*& ptr)
+    {
+        if(!m_checker->isValid(ptr))
+        {
+            m_fallback->fallback(ptr);
+        }
+        return ptr;
+    }
+
+    // declared first to release the block after every holder living in it
+    std::unique_ptr<void, FreeBlock> m_block;
+    T* m_ptr;
+    SmallBuffer<Check> m_checker;
+    SmallBuffer<Fallback> m_fallback;
+    SmallBuffer<Deleter> m_deleter;
+};
+
+template<class T>
+class CheckForNull
+{
+public:
+    bool operator()(T const* ptr) const
+    {
+        return ptr;
+    }
+};
+template<class T>
+class ThrowException
+{
+public:
+    void operator()(T*&) const
+    {
+        throw std::runtime_error("invalid ptr!");
+    }
+};
+// replaces the object through the same AllocationPolicy the deleter uses
+template<class T, class AllocationPolicy = NewDelete<T> >
+class DefaultConstructed
+{
+public:
+    void operator()(T*& ptr)
+    {
+        AllocationPolicy::destroy(ptr);
+        ptr = nullptr;
+        ptr = AllocationPolicy::create();
+    }
+};
+template<class T>
+class Delete
+{
+public:
+    void operator()(T* ptr) const
+    {
+        delete ptr;
+    }
+};
+template<class T>
+class DestroyInPlace
+{
+public:
+    void operator()(T* ptr) const
+    {
+        ptr->~T();
+    }
+};
+// type erased counterpart of the static allocation policies
+template<class T, class AllocationPolicy>
+class DestroyWith
+{
+public:
+    void operator()(T* ptr) const
+    {
+        AllocationPolicy::destroy(ptr);
+    }
+};
+template<class Policy>
+struct allocation_of
+{
+    using type = void;
+};
+template<class T>
+struct allocation_of<Delete<T> >
+{
+    using type = NewDelete<T>;
+};
+template<class T>
+struct allocation_of<DestroyInPlace<T> >
+{
+    using type = DestroyInPlace<T>;
+};
+template<class T, class AllocationPolicy>
+struct allocation_of<DestroyWith<T, AllocationPolicy> >
+{
+    using type = AllocationPolicy;
+};
+template<class T, class AllocationPolicy>
+struct allocation_of<DefaultConstructed<T, AllocationPolicy> >
+{
+    using type = AllocationPolicy;
+};
+// a fallback replacing the object must not be combined with make_safe,
+// the object lives inside the block and is not allocated with new
+template<class T, class CheckingPolicy, class FallbackPolicy, class... Args>
+SafePtr<T> make_safe(const CheckingPolicy& c, const FallbackPolicy& f, Args&&... args)
+{
+    return SafePtr<T>::make(c, f, std::forward<Args>(args)...);
+}
+}
+}
+
+TEST_CASE("type erased SafePtr")
+{
+    SECTION("SafePtr operator* forwarded to ptr")
+    {
+        My::v2::SafePtr<int> sp(
+            new int(179),
+            My::v2::CheckForNull<int>(),
+            My::v2::ThrowException<int>());
+        CHECK((*sp) == 179);
+    }
+    SECTION("SafePtr operator-> forwarded to ptr")
+    {
+        My::v2::SafePtr<std::string> sp(
+            new std::string("string"),
+            My::v2::CheckForNull<std::string>(),
+            My::v2::ThrowException<std::string>());
+        CHECK(sp->size() == 6);
+    }
+    SECTION("SafePtr with nullptr throws")
+    {
+        My::v2::SafePtr<std::string> sp(
+            nullptr,
+            My::v2::CheckForNull<std::string>(),
+            My::v2::ThrowException<std::string>());
+        CHECK_THROWS_AS(void(sp->size() == 6), std::runtime_error);
+    }
+    SECTION("SafePtr with nullptr returns default constructed type")
+    {
+        My::v2::SafePtr<std::string> sp(
+            nullptr,
+            My::v2::CheckForNull<std::string>(),
+            My::v2::DefaultConstructed<std::string>());
+        CHECK(sp->empty());
+        CHECK(sp->size() == 0);
+    }
+    SECTION("SafePtr with nullptr returns default constructed type")
+    {
+        struct Tester
+        {
+            int counter = 0;
+            void operator()(const My::v2::SafePtr<std::string>&)
+            {
+                ++counter;
+            }
+        };
+        My::v2::SafePtr<std::string> sp1(
+            nullptr,
+            My::v2::CheckForNull<std::string>(),
+            My::v2::ThrowException<std::string>());
+        My::v2::SafePtr<std::string> sp2(
+            nullptr,
+            My::v2::CheckForNull<std::string>(),
+            My::v2::DefaultConstructed<std::string>());
+        Tester tester;
+        tester(sp1);
+        tester(sp2);
+        CHECK(tester.counter == 2);
+    }
+}
+
+#include <cstdlib>
+
+// counts every allocation made through the global operator new, all forms
+// of new and delete are replaced so they agree on malloc and free
+namespace heap
+{
+std::atomic<std::size_t> allocations{0};
+
+inline void* allocate(std::size_t size) noexcept
+{
+    ++allocations;
+    return std::malloc(size ? size : 1);
+}
+
+inline void* allocate(std::size_t size, std::align_val_t alignment) noexcept
+{
+    ++allocations;
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+}
+
+template<class... Alignment>
+void* allocateOrThrow(std::size_t size, Alignment... alignment)
+{
+    if(void* ptr = allocate(size, alignment...))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+}
+
+void* operator new(std::size_t size)
+{
+    return heap::allocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return heap::allocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return heap::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return heap::allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return heap::allocateOrThrow(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return heap::allocateOrThrow(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return heap::allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return heap::allocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
 {
-template<class Container>
-void copy_n_impl(
-    const Container& source,
-    Container& target,
-    std::size_t count,
-    std::true_type)
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
 {
-    using value_type = decltype(*std::begin(source));
-    std::memcpy(target, source, sizeof(value_type) * count);
+    std::free(ptr);
 }
-template<class Container>
-void copy_n_impl(
-    const Container& source,
-    Container& target,
-    std::size_t count,
-    std::false_type)
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
 {
-    auto&& b(std::begin(source));
-    auto&& e(std::next(b, count));
-    for(; b != e; ++b)
-    {
-        target.push_back(*b);
-    }
+    std::free(ptr);
 }
-template<class Container>
-void copy_n(const Container& source, Container& target, std::size_t count)
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
 {
-    typedef typename is_array<Container>::type maybe_array;
-    copy_n_impl(source, target, count, maybe_array());
+    std::free(ptr);
 }
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
 }
+
+TEST_CASE("type erased SafePtr holds small policies inline")
+{
+    SECTION("stateless policies need no allocation")
+    {
+        const auto before = heap::allocations.load();
+        My::v2::SafePtr<int> sp(
+            new int(179),
+            My::v2::CheckForNull<int>(),
+            My::v2::ThrowException<int>());
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 1);
+        CHECK((*sp) == 179);
+    }
+    SECTION("large policies fall back to the heap")
+    {
+        struct LargeCheck
+        {
+            char padding[64];
+            bool operator()(int const* ptr) const
+            {
+                return ptr;
+            }
+        };
+        const auto before = heap::allocations.load();
+        My::v2::SafePtr<int> sp(
+            new int(179),
+            LargeCheck(),
+            My::v2::ThrowException<int>());
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 2);
+        CHECK((*sp) == 179);
+    }
 }
 
-TEST_CASE("copy_n for containers")
+TEST_CASE("SafePtr allocation policies")
 {
-    SECTION("container")
+    SECTION("ObjectPool recycles slots")
     {
-        std::list<int> a = {1, 2, 3, 4, 5};
-        std::list<int> b;
-        My::v1::copy_n(a, b, 5);
-        CHECK(a == b);
+        std::string* first = ObjectPool<std::string>::create("string");
+        ObjectPool<std::string>::destroy(first);
+        std::string* second = ObjectPool<std::string>::create("other");
+        CHECK(first == second);
+        ObjectPool<std::string>::destroy(second);
     }
-    SECTION("array")
+    SECTION("pooled SafePtr")
     {
-        int a[] = {1, 2, 3, 4, 5};
-        int b[5];
-        My::v1::copy_n(a, b, 5);
-        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+        using Pool = ObjectPool<std::string>;
+        using Pooled = SafePtr<std::string, CheckForNull<std::string>, ThrowException<std::string>, Pool>;
+        {
+            Pooled sp(Pool::create("string"));
+            CHECK(sp->size() == 6);
+        }
+        const auto before = heap::allocations.load();
+        for(int i = 0; i < 100; ++i)
+        {
+            Pooled sp(Pool::create("string"));
+        }
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 0);
     }
-    SECTION("container")
+    SECTION("arena SafePtr")
     {
-        std::list<int> a = {1, 2, 3, 4, 5};
-        std::list<int> b;
-        My::v2::copy_n(a, b, 5);
-        CHECK(a == b);
+        using Arena = MonotonicArena<std::string>;
+        {
+            SafePtr<std::string, CheckForNull<std::string>, ThrowException<std::string>, Arena>
+            sp(Arena::create("string"));
+            CHECK(sp->size() == 6);
+        }
+        Arena::release();
     }
-    SECTION("array")
+    SECTION("type erased pooled SafePtr")
     {
-        int a[] = {1, 2, 3, 4, 5};
-        int b[5];
-        My::v2::copy_n(a, b, 5);
-        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+        using Pool = ObjectPool<std::string>;
+        {
+            My::v2::SafePtr<std::string> sp(
+                Pool::create("string"),
+                My::v2::CheckForNull<std::string>(),
+                My::v2::ThrowException<std::string>(),
+                My::v2::DestroyWith<std::string, Pool>());
+            CHECK(sp->size() == 6);
+        }
+        const auto before = heap::allocations.load();
+        {
+            My::v2::SafePtr<std::string> sp(
+                Pool::create("string"),
+                My::v2::CheckForNull<std::string>(),
+                My::v2::ThrowException<std::string>(),
+                My::v2::DestroyWith<std::string, Pool>());
+        }
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 0);
     }
-    SECTION("container")
+    SECTION("pooled fallback")
     {
-        std::list<int> a = {1, 2, 3, 4, 5};
-        std::list<int> b;
-        My::v3::copy_n(a, b, 5);
-        CHECK(a == b);
+        using Pool = ObjectPool<std::string>;
+        static_assert(!My::v2::sharesAllocation<
+                      My::v2::DefaultConstructed<std::string>,
+                      My::v2::DestroyWith<std::string, Pool> >(), "");
+        static_assert(!My::v2::sharesAllocation<
+                      My::v2::DefaultConstructed<std::string>,
+                      My::v2::DestroyInPlace<std::string> >(), "");
+        static_assert(My::v2::sharesAllocation<
+                      My::v2::DefaultConstructed<std::string>,
+                      My::v2::Delete<std::string> >(), "");
+        const auto before = heap::allocations.load();
+        {
+            My::v2::SafePtr<std::string> sp(
+                nullptr,
+                My::v2::CheckForNull<std::string>(),
+                My::v2::DefaultConstructed<std::string, Pool>(),
+                My::v2::DestroyWith<std::string, Pool>());
+            CHECK(sp->empty());
+        }
+        // the replacement came from the pool and went back to it
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 0);
     }
-    SECTION("array")
+}
+
+TEST_CASE("SafePtr allocation policies benchmark", "[.][benchmark]")
+{
+    const int count = 10000;
+    using Pool = ObjectPool<std::string>;
+    using Arena = MonotonicArena<std::string>;
+    BENCHMARK("new/delete SafePtr")
     {
-        int a[] = {1, 2, 3, 4, 5};
-        int b[5];
-        My::v3::copy_n(a, b, 5);
-        CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+        std::size_t size = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            SafePtr<std::string> sp(new std::string("string"));
+            size += sp->size();
+        }
+        return size;
+    };
+    BENCHMARK("pooled SafePtr")
+    {
+        std::size_t size = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            SafePtr<std::string, CheckForNull<std::string>, ThrowException<std::string>, Pool>
+            sp(Pool::create("string"));
+            size += sp->size();
+        }
+        return size;
+    };
+    BENCHMARK("arena SafePtr")
+    {
+        std::size_t size = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            SafePtr<std::string, CheckForNull<std::string>, ThrowException<std::string>, Arena>
+            sp(Arena::create("string"));
+            size += sp->size();
+        }
+        Arena::release();
+        return size;
+    };
+}
+
+TEST_CASE("SafePtr is movable")
+{
+    SECTION("policy SafePtr")
+    {
+        std::vector<SafePtr<std::string> > ptrs;
+        for(int i = 0; i < 100; ++i)
+        {
+            ptrs.push_back(make_safe<std::string>(std::size_t(i), 'x'));
+        }
+        CHECK(ptrs[42]->size() == 42);
+        SafePtr<std::string> moved(std::move(ptrs[42]));
+        CHECK(moved->size() == 42);
+        moved = make_safe<std::string>("string");
+        CHECK(moved->size() == 6);
+    }
+    SECTION("type erased SafePtr")
+    {
+        std::vector<My::v2::SafePtr<std::string> > ptrs;
+        for(int i = 0; i < 100; ++i)
+        {
+            ptrs.emplace_back(
+                new std::string(std::size_t(i), 'x'),
+                My::v2::CheckForNull<std::string>(),
+                My::v2::ThrowException<std::string>());
+            ptrs.push_back(My::v2::make_safe<std::string>(
+                               My::v2::CheckForNull<std::string>(),
+                               My::v2::ThrowException<std::string>(),
+                               std::size_t(i), 'y'));
+        }
+        CHECK(ptrs[84]->size() == 42);
+        CHECK(ptrs[85]->size() == 42);
+        My::v2::SafePtr<std::string> moved(std::move(ptrs[85]));
+        CHECK((*moved)[0] == 'y');
+        moved = std::move(ptrs[84]);
+        CHECK((*moved)[0] == 'x');
+        CHECK_THROWS_AS(void(ptrs[85]->size()), std::runtime_error);
+        CHECK_THROWS_AS(void(ptrs[84]->size()), std::runtime_error);
+    }
+}
+
+TEST_CASE("make_safe allocates object and policies in one block")
+{
+    struct LargeCheck
+    {
+        char padding[64];
+        bool operator()(int const* ptr) const
+        {
+            return ptr;
+        }
+    };
+    SECTION("small policies")
+    {
+        const auto before = heap::allocations.load();
+        auto sp = My::v2::make_safe<int>(
+                      My::v2::CheckForNull<int>(),
+                      My::v2::ThrowException<int>(),
+                      179);
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 1);
+        CHECK((*sp) == 179);
+    }
+    SECTION("large policies")
+    {
+        const auto before = heap::allocations.load();
+        auto sp = My::v2::make_safe<int>(
+                      LargeCheck(),
+                      My::v2::ThrowException<int>(),
+                      179);
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 1);
+        auto moved = std::move(sp);
+        CHECK((*moved) == 179);
     }
 }
 
 namespace My
 {
-namespace v2
+namespace v3
 {
+// type erased like v2::SafePtr, the check is a function pointer held
+// in the object and called on the inline buffer, the cold fallback and
+// destroy go through a constant table per policy pair
 template<class T>
 class SafePtr
 {
@@ -1115,15 +4215,22 @@ public:
     template<class CheckingPolicy, class FallbackPolicy>
     SafePtr(T* ptr, const CheckingPolicy& c, const FallbackPolicy& f)
         : m_ptr(ptr)
-        , m_checker(new CheckHolder<CheckingPolicy>(c))
-        , m_fallback(new FallbackHolder<FallbackPolicy>(f))
-    {}
+        , m_isValid(&isValid<Policies<CheckingPolicy, FallbackPolicy>>)
+        , m_vtable(&vtable<Policies<CheckingPolicy, FallbackPolicy>>)
+    {
+        static_assert(
+            v2::sharesAllocation<FallbackPolicy, v2::Delete<T> >(),
+            "the object is released with delete, a fallback must allocate with new");
+        create<Policies<CheckingPolicy, FallbackPolicy>>(c, f);
+    }
+
+    SafePtr(const SafePtr&) = delete;
+    SafePtr& operator=(const SafePtr&) = delete;
 
     ~SafePtr()
     {
+        m_vtable->destroy(&m_buffer);
         delete m_ptr;
-        delete m_checker;
-        delete m_fallback;
     }
 
     T& operator*()
@@ -1136,159 +4243,215 @@ public:
         return getSafePtr(m_ptr);
     }
 private:
-    class Check
+    using IsValid = bool (*)(const void* buffer, T const* ptr);
+
+    struct VTable
     {
-    public:
-        virtual ~Check() {}
-        virtual bool isValid(T const* ptr) const = 0;
+        void (*fallback)(void* buffer, T*& ptr);
+        void (*destroy)(void* buffer);
     };
 
-    class Fallback
+    template<class CheckingPolicy, class FallbackPolicy>
+    struct Policies
     {
-    public:
-        virtual ~Fallback() {}
-        virtual void fallback(T*& ptr) = 0;
+        CheckingPolicy check;
+        FallbackPolicy fallback;
     };
 
-    template<class CheckType>
-    class CheckHolder : public Check
+    using Buffer = std::aligned_storage<2 * sizeof(void*), alignof(std::max_align_t)>::type;
+
+    template<class Held>
+    static constexpr bool fitsInline()
     {
-    public:
-        CheckHolder(const CheckType& value)
-            : m_held(value)
+        return sizeof(Held) <= sizeof(Buffer)
+               && alignof(Held) <= alignof(Buffer);
+    }
+
+    // the buffer holds the policies themselves or a pointer to them
+    template<class Held>
+    static Held* held(void* buffer)
+    {
+        if constexpr(fitsInline<Held>())
+        {
+            return static_cast<Held*>(buffer);
+        }
+        else
         {
+            return *static_cast<Held**>(buffer);
         }
+    }
 
-        virtual bool isValid(T const* ptr) const
+    template<class Held>
+    static const Held* held(const void* buffer)
+    {
+        return held<Held>(const_cast<void*>(buffer));
+    }
+
+    template<class Held>
+    static bool isValid(const void* buffer, T const* ptr)
+    {
+        return held<Held>(buffer)->check(ptr);
+    }
+
+    template<class Held>
+    static constexpr VTable vtable =
+    {
+        [](void* buffer, T*& ptr)
         {
-            return m_held(ptr);
+            held<Held>(buffer)->fallback(ptr);
+        },
+        [](void* buffer)
+        {
+            if constexpr(fitsInline<Held>())
+            {
+                held<Held>(buffer)->~Held();
+            }
+            else
+            {
+                delete held<Held>(buffer);
+            }
         }
-    private:
-        CheckType m_held;
     };
 
-    template<class FallbackType>
-    class FallbackHolder : public Fallback
+    template<class Held, class CheckingPolicy, class FallbackPolicy>
+    void create(const CheckingPolicy& c, const FallbackPolicy& f)
     {
-    public:
-        FallbackHolder(const FallbackType& value)
-            : m_held(value)
+        if constexpr(fitsInline<Held>())
         {
+            new(&m_buffer) Held{c, f};
         }
-
-        virtual void fallback(T*& ptr)
+        else
         {
-            m_held(ptr);
+            new(&m_buffer) Held*(new Held{c, f});
         }
-    private:
-        FallbackType m_held;
-    };
+    }
 
     T* getSafePtr(T*& ptr)
     {
-        if(!m_checker->isValid(ptr))
+        if(!m_isValid(&m_buffer, ptr))
         {
-            m_fallback->fallback(ptr);
+            m_vtable->fallback(&m_buffer, ptr);
         }
         return ptr;
     }
 
     T* m_ptr;
-    const Check* m_checker;
-    Fallback* m_fallback;
-};
-
-template<class T>
-class CheckForNull
-{
-public:
-    bool operator()(T const* ptr) const
-    {
-        return ptr;
-    }
-};
-template<class T>
-class ThrowException
-{
-public:
-    void operator()(T*&) const
-    {
-        throw std::runtime_error("invalid ptr!");
-    }
-};
-template<class T>
-class DefaultConstructed
-{
-public:
-    void operator()(T*& ptr)
-    {
-        delete ptr;
-        ptr = new T();
-    }
+    IsValid m_isValid;
+    const VTable* m_vtable;
+    Buffer m_buffer;
 };
 }
 }
 
-TEST_CASE("type erased SafePtr")
+TEST_CASE("static vtable SafePtr")
 {
+    using My::v2::CheckForNull;
+    using My::v2::ThrowException;
+    using My::v2::DefaultConstructed;
     SECTION("SafePtr operator* forwarded to ptr")
     {
-        My::v2::SafePtr<int> sp(
+        My::v3::SafePtr<int> sp(
             new int(179),
-            My::v2::CheckForNull<int>(),
-            My::v2::ThrowException<int>());
+            CheckForNull<int>(),
+            ThrowException<int>());
         CHECK((*sp) == 179);
     }
     SECTION("SafePtr operator-> forwarded to ptr")
     {
-        My::v2::SafePtr<std::string> sp(
+        My::v3::SafePtr<std::string> sp(
             new std::string("string"),
-            My::v2::CheckForNull<std::string>(),
-            My::v2::ThrowException<std::string>());
+            CheckForNull<std::string>(),
+            ThrowException<std::string>());
         CHECK(sp->size() == 6);
     }
     SECTION("SafePtr with nullptr throws")
     {
-        My::v2::SafePtr<std::string> sp(
+        My::v3::SafePtr<std::string> sp(
             nullptr,
-            My::v2::CheckForNull<std::string>(),
-            My::v2::ThrowException<std::string>());
+            CheckForNull<std::string>(),
+            ThrowException<std::string>());
         CHECK_THROWS_AS(void(sp->size() == 6), std::runtime_error);
     }
     SECTION("SafePtr with nullptr returns default constructed type")
     {
-        My::v2::SafePtr<std::string> sp(
+        My::v3::SafePtr<std::string> sp(
             nullptr,
-            My::v2::CheckForNull<std::string>(),
-            My::v2::DefaultConstructed<std::string>());
+            CheckForNull<std::string>(),
+            DefaultConstructed<std::string>());
         CHECK(sp->empty());
-        CHECK(sp->size() == 0);
     }
-    SECTION("SafePtr with nullptr returns default constructed type")
+    SECTION("stateless policies need no allocation")
     {
-        struct Tester
+        const auto before = heap::allocations.load();
+        My::v3::SafePtr<int> sp(
+            new int(179),
+            CheckForNull<int>(),
+            ThrowException<int>());
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 1);
+    }
+    SECTION("large policies fall back to the heap")
+    {
+        struct LargeCheck
         {
-            int counter = 0;
-            void operator()(const My::v2::SafePtr<std::string>&)
+            char padding[64];
+            bool operator()(int const* ptr) const
             {
-                ++counter;
+                return ptr;
             }
         };
-        My::v2::SafePtr<std::string> sp1(
-            nullptr,
-            My::v2::CheckForNull<std::string>(),
-            My::v2::ThrowException<std::string>());
-        My::v2::SafePtr<std::string> sp2(
-            nullptr,
-            My::v2::CheckForNull<std::string>(),
-            My::v2::DefaultConstructed<std::string>());
-        Tester tester;
-        tester(sp1);
-        tester(sp2);
-        CHECK(tester.counter == 2);
+        const auto before = heap::allocations.load();
+        My::v3::SafePtr<int> sp(
+            new int(179),
+            LargeCheck(),
+            ThrowException<int>());
+        const auto allocated = heap::allocations - before;
+        CHECK(allocated == 2);
+        CHECK((*sp) == 179);
     }
 }
 
+TEST_CASE("SafePtr dereference benchmark", "[.][benchmark]")
+{
+    const int iterations = 1000000;
+    SafePtr<int> policies(new int(1));
+    My::v2::SafePtr<int> virtuals(
+        new int(1),
+        My::v2::CheckForNull<int>(),
+        My::v2::ThrowException<int>());
+    My::v3::SafePtr<int> vtable(
+        new int(1),
+        My::v2::CheckForNull<int>(),
+        My::v2::ThrowException<int>());
+    BENCHMARK("policy template SafePtr")
+    {
+        int sum = 0;
+        for(int i = 0; i < iterations; ++i)
+        {
+            sum += *policies;
+        }
+        return sum;
+    };
+    BENCHMARK("virtual holders SafePtr")
+    {
+        int sum = 0;
+        for(int i = 0; i < iterations; ++i)
+        {
+            sum += *virtuals;
+        }
+        return sum;
+    };
+    BENCHMARK("static vtable SafePtr")
+    {
+        int sum = 0;
+        for(int i = 0; i < iterations; ++i)
+        {
+            sum += *vtable;
+        }
+        return sum;
+    };
+}
+
 namespace geometry
 {
 namespace lib_one
@@ -1389,3 +4552,543 @@ TEST_CASE("boost.fusion distance of two points")
     p2.y(6);
     CHECK(4.0 == lib::distance(p1, p2));
 }
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/value_at.hpp>
+#include <cmath>
+#include <utility>
+
+namespace geometry
+{
+namespace lib
+{
+namespace adt
+{
+// getters of a BOOST_FUSION_ADAPT_ADT type which may be called directly
+// instead of going through fusion's adt_attribute_proxy:
+//   template<> struct inline_accessors<Type>
+//   { static constexpr auto getters = std::make_tuple(&Type::getter...); };
+template<class Adt>
+struct inline_accessors
+{};
+
+template<class P, class = void>
+struct has_inline_accessors : std::false_type
+{};
+
+template<class P>
+struct has_inline_accessors<P, std::void_t<decltype(inline_accessors<P>::getters)>>
+    : std::true_type
+{};
+
+// a getter is inlined if it is a const member function without arguments
+// returning an arithmetic value
+template<class Getter>
+struct accessor_traits
+{
+    static constexpr bool inlinable = false;
+};
+
+template<class R, class C>
+struct accessor_traits<R (C::*)() const>
+{
+    using type = R;
+    static constexpr bool inlinable = std::is_arithmetic<R>::value;
+};
+
+template<class R, class C>
+struct accessor_traits<R (C::*)() const noexcept>
+    : accessor_traits<R (C::*)() const>
+{};
+
+template<class P, int I>
+using getter_t = typename std::decay<
+    decltype(std::get<I>(inline_accessors<P>::getters))>::type;
+
+template<class P, class Is = std::make_integer_sequence<
+    int, boost::fusion::result_of::size<P>::value>>
+struct is_proxied;
+
+// fusion hands out proxies instead of references for ADAPT_ADT members
+template<class P, int... Is>
+struct is_proxied<P, std::integer_sequence<int, Is...>>
+    : std::integral_constant<bool, (!std::is_reference<
+        typename boost::fusion::result_of::at_c<const P, Is>::type>::value || ...)>
+{};
+
+template<int I, class P>
+decltype(auto) member(const P& p)
+{
+    if constexpr(has_inline_accessors<P>::value)
+    {
+        return (p.*std::get<I>(inline_accessors<P>::getters))();
+    }
+    else
+    {
+        return boost::fusion::at_c<I>(p);
+    }
+}
+
+template<class P, int... Is>
+auto read_members(const P& p, std::integer_sequence<int, Is...>)
+{
+    static_assert(
+        (accessor_traits<getter_t<P, Is>>::inlinable && ...),
+        "inline_accessors must be const, take no arguments and return arithmetic values");
+    return boost::fusion::vector<typename accessor_traits<getter_t<P, Is>>::type...>(
+        member<Is>(p)...);
+}
+
+// adapted structs are passed through,
+// adapted ADTs are read once into a fusion::vector of plain values
+template<class P>
+decltype(auto) unproxied(const P& p)
+{
+    if constexpr(!is_proxied<P>::value)
+    {
+        return (p);
+    }
+    else
+    {
+        static_assert(
+            has_inline_accessors<P>::value,
+            "ADAPT_ADT type without inline_accessors, members are read through proxies");
+        return read_members(
+            p, std::make_integer_sequence<int, boost::fusion::result_of::size<P>::value>());
+    }
+}
+
+template<>
+struct inline_accessors<lib_two::Point>
+{
+    static constexpr auto getters = std::make_tuple(
+        static_cast<int (lib_two::Point::*)() const>(&lib_two::Point::x),
+        static_cast<int (lib_two::Point::*)() const>(&lib_two::Point::y));
+};
+}
+}
+}
+
+namespace geometry
+{
+namespace lib
+{
+namespace batch
+{
+constexpr std::size_t block_size = 256;
+
+template<class P, int I>
+using coordinate_t = typename std::decay<
+    typename boost::fusion::result_of::value_at_c<P, I>::type>::type;
+
+inline void sqrt_kernel(double* values, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(__AVX__)
+    for(; i + 4 <= count; i += 4)
+    {
+        _mm256_storeu_pd(values + i, _mm256_sqrt_pd(_mm256_loadu_pd(values + i)));
+    }
+#elif defined(__SSE2__)
+    for(; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(values + i, _mm_sqrt_pd(_mm_loadu_pd(values + i)));
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        values[i] = std::sqrt(values[i]);
+    }
+}
+
+template<class T>
+constexpr auto square(T value)
+{
+    return value * value;
+}
+
+// sum of the squared differences in the member types, in the order
+// the scalar distance accumulates them, so int members stay integers
+template<class P1, class P2, int... Is>
+auto squared_distance(const P1& p1, const P2& p2, std::integer_sequence<int, Is...>)
+{
+    return (0 + ... + square(adt::member<Is>(p1) - adt::member<Is>(p2)));
+}
+
+// one pass over the block: every point is read once (plain member reads for
+// ADAPT_STRUCT, accessor calls for ADAPT_ADT) and only its sum is converted,
+// the square roots are then taken on the block while it is still in L1
+template<class P1, class P2, int... Is>
+void distance_block(
+    const P1* p1, const P2* p2, std::size_t count, double* result,
+    std::integer_sequence<int, Is...> axes)
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        result[i] = double(squared_distance(p1[i], p2[i], axes));
+    }
+    sqrt_kernel(result, count);
+}
+}
+
+template<class P1, class P2>
+void distance(const P1* p1, const P2* p2, std::size_t count, double* result)
+{
+    using namespace boost::fusion;
+    static_assert(
+        tuple_size<P1>::value
+        ==
+        tuple_size<P2>::value,
+        "points must have same dimension");
+    using axes = std::make_integer_sequence<int, tuple_size<P1>::value>;
+    for(std::size_t first = 0; first < count; first += batch::block_size)
+    {
+        const auto n = std::min(batch::block_size, count - first);
+        batch::distance_block(p1 + first, p2 + first, n, result + first, axes());
+    }
+}
+}
+}
+
+namespace
+{
+template<class Point>
+std::vector<Point> randomPoints(std::size_t count)
+{
+    std::mt19937 gen(count);
+    std::uniform_int_distribution<int> coordinate(-1000, 1000);
+    std::vector<Point> points(count);
+    for(auto& p : points)
+    {
+        boost::fusion::at_c<0>(p) = coordinate(gen);
+        boost::fusion::at_c<1>(p) = coordinate(gen);
+    }
+    return points;
+}
+}
+
+TEST_CASE("boost.fusion batch distance of point arrays")
+{
+    using namespace geometry;
+    const std::size_t count = 1001;
+    const auto ones = randomPoints<lib_one::Point>(count);
+    const auto twos = randomPoints<lib_two::Point>(count + 1);
+    std::vector<double> result(count);
+    SECTION("struct to adt")
+    {
+        lib::distance(ones.data(), twos.data(), count, result.data());
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            CHECK(result[i] == lib::distance(ones[i], twos[i]));
+        }
+    }
+    SECTION("adt to adt")
+    {
+        lib::distance(twos.data(), twos.data() + 1, count, result.data());
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            CHECK(result[i] == lib::distance(twos[i], twos[i + 1]));
+        }
+    }
+    SECTION("floating point members")
+    {
+        using Point = boost::fusion::vector<double, double>;
+        const Point p1[] = {Point(0.5, 1.5), Point(-3.0, 2.0), Point(1.0, 1.0)};
+        const Point p2[] = {Point(3.5, 5.5), Point(-3.0, 2.0), Point(2.0, 1.0)};
+        double distances[3];
+        lib::distance(p1, p2, 3, distances);
+        CHECK(distances[0] == 5.0);
+        CHECK(distances[1] == 0.0);
+        CHECK(distances[2] == 1.0);
+    }
+}
+
+#include <boost/fusion/include/for_each.hpp>
+#include <tuple>
+
+namespace geometry
+{
+namespace lib
+{
+// structure of arrays built from the fusion metadata of Struct:
+// every adapted member lives in its own contiguous column
+template<class Struct>
+class soa_vector
+{
+    static constexpr int members = boost::fusion::result_of::size<Struct>::value;
+    using indices = std::make_integer_sequence<int, members>;
+
+    template<int I>
+    using member_t = batch::coordinate_t<Struct, I>;
+
+    template<class Indices>
+    struct layout;
+
+    template<int... Is>
+    struct layout<std::integer_sequence<int, Is...>>
+    {
+        using columns = std::tuple<std::vector<member_t<Is>>...>;
+        using reference = boost::fusion::vector<member_t<Is>&...>;
+        using const_reference = boost::fusion::vector<const member_t<Is>&...>;
+    };
+public:
+    using value_type = Struct;
+    using reference = typename layout<indices>::reference;
+    using const_reference = typename layout<indices>::const_reference;
+
+    std::size_t size() const
+    {
+        return std::get<0>(m_columns).size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    void reserve(std::size_t count)
+    {
+        reserve(count, indices());
+    }
+
+    void push_back(const Struct& value)
+    {
+        push_back(value, indices());
+    }
+
+    reference operator[](std::size_t pos)
+    {
+        return at<reference>(*this, pos, indices());
+    }
+
+    const_reference operator[](std::size_t pos) const
+    {
+        return at<const_reference>(*this, pos, indices());
+    }
+
+    template<int I>
+    std::vector<member_t<I>>& column()
+    {
+        return std::get<I>(m_columns);
+    }
+
+    template<int I>
+    const std::vector<member_t<I>>& column() const
+    {
+        return std::get<I>(m_columns);
+    }
+private:
+    template<int... Is>
+    void reserve(std::size_t count, std::integer_sequence<int, Is...>)
+    {
+        (std::get<Is>(m_columns).reserve(count), ...);
+    }
+
+    template<int... Is>
+    void push_back(const Struct& value, std::integer_sequence<int, Is...>)
+    {
+        (std::get<Is>(m_columns).push_back(
+             member_t<Is>(boost::fusion::at_c<Is>(value))), ...);
+    }
+
+    template<class Reference, class Self, int... Is>
+    static Reference at(Self& self, std::size_t pos, std::integer_sequence<int, Is...>)
+    {
+        return Reference(std::get<Is>(self.m_columns)[pos]...);
+    }
+
+    typename layout<indices>::columns m_columns;
+};
+
+namespace batch
+{
+// same fused pass as for point arrays, the columns are contiguous
+// so the compiler vectorizes the integer sums without a gather
+template<class P1, class P2, int... Is>
+void distance_block(
+    const soa_vector<P1>& p1, const soa_vector<P2>& p2,
+    std::size_t first, std::size_t count, double* result,
+    std::integer_sequence<int, Is...>)
+{
+    const auto columns1 = std::make_tuple(p1.template column<Is>().data() + first...);
+    const auto columns2 = std::make_tuple(p2.template column<Is>().data() + first...);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        result[i] = double(
+            (0 + ... + square(std::get<Is>(columns1)[i] - std::get<Is>(columns2)[i])));
+    }
+    sqrt_kernel(result, count);
+}
+}
+
+// columns are already packed, the blocks read them in place
+template<class P1, class P2>
+void distance(const soa_vector<P1>& p1, const soa_vector<P2>& p2, double* result)
+{
+    using namespace boost::fusion;
+    static_assert(
+        tuple_size<P1>::value
+        ==
+        tuple_size<P2>::value,
+        "points must have same dimension");
+    assert(p1.size() == p2.size());
+    using axes = std::make_integer_sequence<int, tuple_size<P1>::value>;
+    const auto count = p1.size();
+    for(std::size_t first = 0; first < count; first += batch::block_size)
+    {
+        const auto n = std::min(batch::block_size, count - first);
+        batch::distance_block(p1, p2, first, n, result + first, axes());
+    }
+}
+}
+}
+
+TEST_CASE("soa_vector from fusion adapted structs")
+{
+    using namespace geometry;
+    const std::size_t count = 1001;
+    const auto ones = randomPoints<lib_one::Point>(count);
+    const auto twos = randomPoints<lib_two::Point>(count);
+    lib::soa_vector<lib_one::Point> soaOnes;
+    lib::soa_vector<lib_two::Point> soaTwos;
+    soaOnes.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        soaOnes.push_back(ones[i]);
+        soaTwos.push_back(twos[i]);
+    }
+    REQUIRE(soaOnes.size() == count);
+    SECTION("members are stored column wise")
+    {
+        CHECK(soaOnes.column<0>()[7] == ones[7].x);
+        CHECK(soaOnes.column<1>()[7] == ones[7].y);
+        CHECK(soaTwos.column<0>()[7] == twos[7].x());
+        CHECK(soaTwos.column<1>()[7] == twos[7].y());
+    }
+    SECTION("proxy references are fusion sequences")
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            CHECK(lib::distance(soaOnes[i], twos[i]) == lib::distance(ones[i], twos[i]));
+        }
+        boost::fusion::for_each(soaOnes[3], [](int& member) { member = 0; });
+        CHECK(soaOnes.column<0>()[3] == 0);
+        CHECK(soaOnes.column<1>()[3] == 0);
+    }
+    SECTION("batch distance on columns")
+    {
+        std::vector<double> result(count);
+        lib::distance(soaOnes, soaTwos, result.data());
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            CHECK(result[i] == lib::distance(ones[i], twos[i]));
+        }
+    }
+}
+
+TEST_CASE("boost.fusion batch distance benchmark", "[.][benchmark]")
+{
+    using namespace geometry;
+    const std::size_t count = 100000;
+    const auto ones = randomPoints<lib_one::Point>(count);
+    const auto twos = randomPoints<lib_two::Point>(count);
+    std::vector<double> result(count);
+    BENCHMARK("scalar fusion distance")
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            result[i] = lib::distance(ones[i], twos[i]);
+        }
+        return result.back();
+    };
+    BENCHMARK("batch distance")
+    {
+        lib::distance(ones.data(), twos.data(), count, result.data());
+        return result.back();
+    };
+    lib::soa_vector<lib_one::Point> soaOnes;
+    lib::soa_vector<lib_two::Point> soaTwos;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        soaOnes.push_back(ones[i]);
+        soaTwos.push_back(twos[i]);
+    }
+    BENCHMARK("batch distance on soa_vector")
+    {
+        lib::distance(soaOnes, soaTwos, result.data());
+        return result.back();
+    };
+}
+
+namespace
+{
+double handWrittenDistance(
+    const geometry::lib_one::Point& p1, const geometry::lib_two::Point& p2)
+{
+    const int dx = p1.x - p2.x();
+    const int dy = p1.y - p2.y();
+    return std::sqrt(dx * dx + dy * dy);
+}
+}
+
+TEST_CASE("boost.fusion adt members read through inline accessors")
+{
+    using namespace geometry;
+    static_assert(lib::adt::is_proxied<lib_two::Point>::value, "");
+    static_assert(!lib::adt::is_proxied<lib_one::Point>::value, "");
+    static_assert(lib::adt::has_inline_accessors<lib_two::Point>::value, "");
+    static_assert(!lib::adt::accessor_traits<void (lib_two::Point::*)(int)>::inlinable, "");
+    lib_one::Point p1{};
+    p1.x = 2;
+    p1.y = 2;
+    lib_two::Point p2{};
+    p2.x(2);
+    p2.y(6);
+    static_assert(
+        std::is_same<decltype(lib::adt::unproxied(p1)), const lib_one::Point&>::value, "");
+    static_assert(
+        std::is_same<
+        decltype(lib::adt::unproxied(p2)),
+        boost::fusion::vector<int, int>
+        >::value, "");
+    CHECK(4.0 == lib::distance(p1, lib::adt::unproxied(p2)));
+    CHECK(handWrittenDistance(p1, p2) == lib::distance(p1, lib::adt::unproxied(p2)));
+}
+
+TEST_CASE("boost.fusion adt inline accessors benchmark", "[.][benchmark]")
+{
+    using namespace geometry;
+    const std::size_t count = 100000;
+    const auto ones = randomPoints<lib_one::Point>(count);
+    const auto twos = randomPoints<lib_two::Point>(count);
+    BENCHMARK("distance through adt proxies")
+    {
+        double sum = 0.0;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            sum += lib::distance(ones[i], twos[i]);
+        }
+        return sum;
+    };
+    BENCHMARK("distance through inline accessors")
+    {
+        double sum = 0.0;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            sum += lib::distance(ones[i], lib::adt::unproxied(twos[i]));
+        }
+        return sum;
+    };
+    BENCHMARK("hand written distance")
+    {
+        double sum = 0.0;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            sum += handWrittenDistance(ones[i], twos[i]);
+        }
+        return sum;
+    };
+}
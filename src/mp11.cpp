@@ -1,4 +1,5 @@
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
 #include <algorithm>
 #include <deque>
@@ -13,9 +14,16 @@
 #include <random>
 #include <set>
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
 class string_view
 {
   public:
+    using size_type = decltype(sizeof(""));
+    constexpr static size_type npos{static_cast<size_type>(-1)};
+
     constexpr string_view() = default;
     template <class TStr>
     constexpr /*explicit(false)*/ string_view(const TStr& str)
@@ -23,17 +31,12 @@ class string_view
         , size_{str.size()}
     {
     }
-    /*constexpr*/ /*explicit(false)*/ string_view(const char* const data)
+    constexpr /*explicit(false)*/ string_view(const char* const data)
         : data_{data}
-        , size_{[data] {
-            decltype(sizeof("")) size{};
-            for (size = {}; data[size] != '\0'; ++size)
-                ;
-            return size;
-        }()}
+        , size_{std::char_traits<char>::length(data)}
     {
     }
-    constexpr string_view(const char* const data, decltype(sizeof("")) size)
+    constexpr string_view(const char* const data, size_type size)
         : data_{data}
         , size_{size}
     {
@@ -55,23 +58,124 @@ class string_view
         os.write(sv.data_, long(sv.size_));
         return os;
     }
-    [[nodiscard]] friend auto operator==(const string_view& a, const string_view& b) -> bool
+    // sizes first, equal prefixes of different length are different strings
+    [[nodiscard]] friend constexpr auto operator==(const string_view& a, const string_view& b) -> bool
+    {
+        return a.size_ == b.size_ && traits::compare(a.data_, b.data_, a.size_) == 0;
+    }
+    [[nodiscard]] friend constexpr auto operator!=(const string_view& a, const string_view& b) -> bool
+    {
+        return !(a == b);
+    }
+    [[nodiscard]] friend constexpr auto operator<(const string_view& a, const string_view& b) -> bool
+    {
+        return a.compare(b) < 0;
+    }
+    [[nodiscard]] constexpr auto compare(const string_view& other) const -> int
+    {
+        const auto result = traits::compare(data_, other.data_, std::min(size_, other.size_));
+        if (result != 0)
+            return result;
+        return size_ == other.size_ ? 0 : size_ < other.size_ ? -1 : 1;
+    }
+    [[nodiscard]] constexpr auto data() const -> const char*
+    {
+        return data_;
+    }
+    [[nodiscard]] constexpr auto size() const -> size_type
+    {
+        return size_;
+    }
+    [[nodiscard]] constexpr auto empty() const -> bool
+    {
+        return size_ == 0;
+    }
+    [[nodiscard]] constexpr auto operator[](size_type i) const -> char
     {
-        return strncmp(a.data_, b.data_, (std::min(a.size_, b.size_))) == 0;
+        return data_[i];
     }
+    [[nodiscard]] constexpr auto begin() const -> const char*
+    {
+        return data_;
+    }
+    [[nodiscard]] constexpr auto end() const -> const char*
+    {
+        return data_ + size_;
+    }
+    [[nodiscard]] constexpr auto find(char c, size_type pos = 0) const -> size_type
+    {
+        if (pos >= size_)
+            return npos;
+        const auto* found = traits::find(data_ + pos, size_ - pos, c);
+        return found ? size_type(found - data_) : npos;
+    }
+    // jumps from one occurrence of the first character to the next
+    [[nodiscard]] constexpr auto find(const string_view& needle, size_type pos = 0) const -> size_type
+    {
+        const auto n = needle.size_;
+        if (n == 0)
+            return pos <= size_ ? pos : npos;
+        if (pos >= size_ || size_ - pos < n)
+            return npos;
+        const char* const last = data_ + size_ - n + 1;
+        for (const char* candidate = data_ + pos; candidate < last; ++candidate)
+        {
+            candidate = traits::find(candidate, size_type(last - candidate), needle.data_[0]);
+            if (!candidate)
+                return npos;
+            if (traits::compare(candidate + 1, needle.data_ + 1, n - 1) == 0)
+                return size_type(candidate - data_);
+        }
+        return npos;
+    }
+    [[nodiscard]] auto hash() const -> std::size_t
+    {
+        return std::hash<std::string_view>{}(std::string_view{data_, size_});
+    }
+
   private:
+    // constexpr, and memcmp, memchr and strlen of the C library at run time
+    using traits = std::char_traits<char>;
+
     const char* data_{};
-    decltype(sizeof("")) size_{};
+    size_type size_{};
 };
+namespace std
+{
+template <>
+struct hash<::string_view>
+{
+    auto operator()(const ::string_view& sv) const -> size_t
+    {
+        return sv.hash();
+    }
+};
+} // namespace std
 template <class T>
 constexpr auto type_name() -> string_view
 {
 #if defined(_MSC_VER) and not defined(__clang__)
     return {&__FUNCSIG__[36], sizeof(__FUNCSIG__) - 44};
-#elif defined(__clang__)
-    return {&__PRETTY_FUNCTION__[29], sizeof(__PRETTY_FUNCTION__) - 2};
-#elif defined(__GNUC__)
-    return {&__PRETTY_FUNCTION__[103], sizeof(__PRETTY_FUNCTION__) - 105};
+#else
+    // "... [T = int]" (clang) or "... [with T = int]" (gcc), the type ends
+    // at the closing bracket or at "; " if gcc lists more parameters
+    const char* const name = __PRETTY_FUNCTION__;
+    const auto size = sizeof(__PRETTY_FUNCTION__) - 1;
+    decltype(sizeof("")) first{};
+    while (first + 4 <= size &&
+           !(name[first] == 'T' && name[first + 1] == ' ' && name[first + 2] == '=' && name[first + 3] == ' '))
+        ++first;
+    first += 4;
+    auto last = size - 1;
+    for (auto i = first; i + 1 < last; ++i)
+    {
+        if (name[i] == ';' && name[i + 1] == ' ')
+        {
+            last = i;
+            break;
+        }
+    }
+    return {name + first, last - first};
 #endif
 }
 /*
@@ -608,3 +712,924 @@ TEST_CASE("MaxSize<T1, T2>")
         static_assert(MaxSize<char, int, double>::value == sizeof(double), "");
     }
 }
+/*
+
+MaxSize as storage engine for a tagged union
+
+*/
+#include <boost/mp11/set.hpp>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+namespace Mp11
+{
+template <class T>
+struct alignof_t
+{
+    using type = T;
+    constexpr static auto value{alignof(T)};
+};
+template <class T, class... Ts>
+struct MaxAlign
+{
+  private:
+    using result = boost::mp11::mp_max<alignof_t<T>, alignof_t<Ts>...>;
+
+  public:
+    using type = typename result::type;
+    constexpr static auto value{alignof(type)};
+};
+// the smallest unsigned type which can count to N
+template <std::size_t N>
+using smallest_unsigned_t = std::conditional_t<
+    (N <= UINT8_MAX),
+    std::uint8_t,
+    std::conditional_t<(N <= UINT16_MAX), std::uint16_t, std::uint32_t>>;
+class bad_inline_variant_access : public std::logic_error
+{
+  public:
+    bad_inline_variant_access()
+        : std::logic_error("inline_variant does not hold the requested type")
+    {
+    }
+};
+// all alternatives share one buffer sized by MaxSize and aligned by MaxAlign,
+// visitation jumps through a table with one entry per alternative,
+// alternatives must not throw on move so that a variant always holds a value
+template <class... Ts>
+class inline_variant
+{
+    static_assert(sizeof...(Ts) > 0, "inline_variant needs at least one alternative");
+    static_assert(boost::mp11::mp_is_set<boost::mp11::mp_list<Ts...>>::value,
+                  "inline_variant alternatives must be distinct");
+    static_assert((std::is_nothrow_move_constructible<Ts>::value && ...),
+                  "inline_variant alternatives must be nothrow move constructible");
+
+    using list = boost::mp11::mp_list<Ts...>;
+    using first = boost::mp11::mp_front<list>;
+
+  public:
+    using index_type = smallest_unsigned_t<sizeof...(Ts)>;
+    template <class T>
+    constexpr static std::size_t index_of = boost::mp11::mp_find<list, T>::value;
+    template <class T>
+    constexpr static bool is_alternative = index_of<T> < sizeof...(Ts);
+
+    inline_variant()
+    {
+        construct<first>();
+    }
+    template <class T,
+              class U = std::decay_t<T>,
+              class = std::enable_if_t<is_alternative<U>>>
+    inline_variant(T&& value)
+    {
+        construct<U>(std::forward<T>(value));
+    }
+    inline_variant(const inline_variant& other)
+    {
+        other.visit([this](const auto& value) { construct<std::decay_t<decltype(value)>>(value); });
+    }
+    inline_variant(inline_variant&& other) noexcept
+    {
+        other.visit([this](auto& value) { construct<std::decay_t<decltype(value)>>(std::move(value)); });
+    }
+    inline_variant& operator=(const inline_variant& other)
+    {
+        if (this != &other)
+        {
+            inline_variant copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+    inline_variant& operator=(inline_variant&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            other.visit([this](auto& value) { construct<std::decay_t<decltype(value)>>(std::move(value)); });
+        }
+        return *this;
+    }
+    ~inline_variant()
+    {
+        destroy();
+    }
+    template <class T, class... Args>
+    T& emplace(Args&&... args)
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        // build first, the old value stays intact if T's constructor throws
+        T value(std::forward<Args>(args)...);
+        destroy();
+        return construct<T>(std::move(value));
+    }
+    [[nodiscard]] std::size_t index() const
+    {
+        return index_;
+    }
+    template <class T>
+    [[nodiscard]] bool holds_alternative() const
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        return index_ == index_of<T>;
+    }
+    template <class T>
+    [[nodiscard]] T* get_if()
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        return holds_alternative<T>() ? std::launder(reinterpret_cast<T*>(storage_)) : nullptr;
+    }
+    template <class T>
+    [[nodiscard]] const T* get_if() const
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        return holds_alternative<T>() ? std::launder(reinterpret_cast<const T*>(storage_)) : nullptr;
+    }
+    template <class T>
+    [[nodiscard]] T& get()
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        if (auto* value = get_if<T>())
+            return *value;
+        throw bad_inline_variant_access();
+    }
+    template <class T>
+    [[nodiscard]] const T& get() const
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        if (auto* value = get_if<T>())
+            return *value;
+        throw bad_inline_variant_access();
+    }
+    // f is called with the held alternative, all calls must return the same type
+    template <class F>
+    decltype(auto) visit(F&& f)
+    {
+        return dispatch(*this, std::forward<F>(f));
+    }
+    template <class F>
+    decltype(auto) visit(F&& f) const
+    {
+        return dispatch(*this, std::forward<F>(f));
+    }
+
+  private:
+    template <class T, class... Args>
+    T& construct(Args&&... args)
+    {
+        static_assert(is_alternative<T>, "T is not an alternative of this inline_variant");
+        auto* value = ::new (static_cast<void*>(storage_)) T(std::forward<Args>(args)...);
+        index_ = static_cast<index_type>(index_of<T>);
+        return *value;
+    }
+    void destroy()
+    {
+        visit([](auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            value.~T();
+        });
+    }
+    template <class Self, class F, class R, class T>
+    static R invoke(Self& self, F&& f)
+    {
+        using Held = std::conditional_t<std::is_const<Self>::value, const T, T>;
+        return std::forward<F>(f)(*std::launder(reinterpret_cast<Held*>(self.storage_)));
+    }
+    template <class Self, class F>
+    static decltype(auto) dispatch(Self& self, F&& f)
+    {
+        using Held = std::conditional_t<std::is_const<Self>::value, const first, first>;
+        using R = decltype(std::declval<F>()(std::declval<Held&>()));
+        constexpr static R (*table[])(Self&, F &&) = {&invoke<Self, F, R, Ts>...};
+        return table[self.index_](self, std::forward<F>(f));
+    }
+
+    alignas(MaxAlign<Ts...>::value) unsigned char storage_[v6::MaxSize<Ts...>::value];
+    index_type index_{};
+};
+template <class F, class... Ts>
+decltype(auto) visit(F&& f, inline_variant<Ts...>& v)
+{
+    return v.visit(std::forward<F>(f));
+}
+template <class F, class... Ts>
+decltype(auto) visit(F&& f, const inline_variant<Ts...>& v)
+{
+    return v.visit(std::forward<F>(f));
+}
+} // namespace Mp11
+#include <string>
+#include <variant>
+TEST_CASE("inline_variant")
+{
+    using Mp11::inline_variant;
+    using Message = inline_variant<char, int, double>;
+    static_assert(std::is_same<Message::index_type, std::uint8_t>::value, "");
+    static_assert(alignof(Message) == alignof(double), "");
+    static_assert(sizeof(Message) == 2 * sizeof(double), "");
+    static_assert(sizeof(Message) <= sizeof(std::variant<char, int, double>), "");
+    static_assert(std::is_same<Mp11::smallest_unsigned_t<256>, std::uint16_t>::value, "");
+    static_assert(std::is_same<Mp11::smallest_unsigned_t<70000>, std::uint32_t>::value, "");
+    static_assert(Mp11::MaxAlign<char, short, double>::value == alignof(double), "");
+    static_assert(Message::is_alternative<int>, "");
+    static_assert(!Message::is_alternative<long double>, "");
+
+    SECTION("default holds the first alternative")
+    {
+        const Message m;
+        CHECK(m.index() == 0);
+        CHECK(m.get<char>() == '\0');
+    }
+    SECTION("visit")
+    {
+        Message m{42};
+        CHECK(m.holds_alternative<int>());
+        CHECK(m.get<int>() == 42);
+        CHECK(m.get_if<double>() == nullptr);
+        CHECK_THROWS_AS(m.get<double>(), Mp11::bad_inline_variant_access);
+        m = 1.5;
+        CHECK(m.index() == 2);
+        CHECK(visit([](auto value) { return double(value) * 2; }, m) == 3.0);
+        m.visit([](auto& value) { value += 1; });
+        CHECK(m.get<double>() == 2.5);
+    }
+    SECTION("non trivial alternatives")
+    {
+        using Payload = inline_variant<int, std::string, std::vector<int>>;
+        Payload a{std::string(100, 'x')};
+        Payload b{a};
+        CHECK(b.get<std::string>() == std::string(100, 'x'));
+        Payload c{std::move(a)};
+        CHECK(c.get<std::string>().size() == 100);
+        b.emplace<std::vector<int>>(3, 7);
+        CHECK(b.get<std::vector<int>>() == std::vector<int>{7, 7, 7});
+        c = b;
+        CHECK(c.holds_alternative<std::vector<int>>());
+        c = 5;
+        CHECK(c.get<int>() == 5);
+    }
+}
+/*
+
+MaxSize and MaxAlign as layout optimizer
+
+*/
+#include <array>
+#include <tuple>
+namespace Mp11
+{
+// members are stored by decreasing alignment, every member then starts at a
+// multiple of its alignment and only the tail is padded, get<I> still uses
+// the declaration order
+template <class... Ts>
+class packed_tuple
+{
+    static_assert(sizeof...(Ts) > 0, "packed_tuple needs at least one member");
+
+    using list = boost::mp11::mp_list<Ts...>;
+    constexpr static std::size_t count{sizeof...(Ts)};
+    struct aligned_before
+    {
+        template <class I, class J>
+        using fn = boost::mp11::mp_bool<
+            (alignof(boost::mp11::mp_at<list, I>) > alignof(boost::mp11::mp_at<list, J>)) ||
+            (alignof(boost::mp11::mp_at<list, I>) == alignof(boost::mp11::mp_at<list, J>) && I::value < J::value)>;
+    };
+
+  public:
+    // declaration indices in storage order
+    using order = boost::mp11::mp_sort_q<boost::mp11::mp_iota_c<count>, aligned_before>;
+
+  private:
+    template <class... Is>
+    constexpr static auto offsets_of(boost::mp11::mp_list<Is...>)
+    {
+        const std::size_t sizes[]{sizeof(Ts)...};
+        const std::size_t slots[]{Is::value...};
+        std::array<std::size_t, count> result{};
+        std::size_t offset{};
+        for (std::size_t slot = 0; slot < count; ++slot)
+        {
+            result[slots[slot]] = offset;
+            offset += sizes[slots[slot]];
+        }
+        return result;
+    }
+
+  public:
+    // offset of every member, in declaration order
+    constexpr static std::array<std::size_t, count> offsets{offsets_of(order{})};
+    template <std::size_t I>
+    using element_type = boost::mp11::mp_at_c<list, I>;
+
+    packed_tuple()
+    {
+        construct([](auto tag) { return typename decltype(tag)::type{}; });
+    }
+    explicit packed_tuple(Ts... values)
+    {
+        std::tuple<Ts&...> refs{values...};
+        construct([&refs](auto tag) { return std::move(std::get<decltype(tag)::index>(refs)); });
+    }
+    packed_tuple(const packed_tuple& other)
+    {
+        construct([&other](auto tag) { return other.template get<decltype(tag)::index>(); });
+    }
+    packed_tuple(packed_tuple&& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<Ts>...>::value)
+    {
+        construct([&other](auto tag) { return std::move(other.template get<decltype(tag)::index>()); });
+    }
+    packed_tuple& operator=(const packed_tuple& other)
+    {
+        assign(other, std::make_index_sequence<count>{});
+        return *this;
+    }
+    packed_tuple& operator=(packed_tuple&& other) noexcept(
+        std::conjunction<std::is_nothrow_move_assignable<Ts>...>::value)
+    {
+        assign(std::move(other), std::make_index_sequence<count>{});
+        return *this;
+    }
+    ~packed_tuple()
+    {
+        destroy_first(count, std::make_index_sequence<count>{});
+    }
+    template <std::size_t I>
+    [[nodiscard]] element_type<I>& get()
+    {
+        return *std::launder(reinterpret_cast<element_type<I>*>(storage_ + offsets[I]));
+    }
+    template <std::size_t I>
+    [[nodiscard]] const element_type<I>& get() const
+    {
+        return *std::launder(reinterpret_cast<const element_type<I>*>(storage_ + offsets[I]));
+    }
+
+  private:
+    template <std::size_t I>
+    struct member_tag
+    {
+        using type = element_type<I>;
+        constexpr static std::size_t index{I};
+    };
+    // make(member_tag<I>) returns the initial value of member I
+    template <class Make>
+    void construct(Make make)
+    {
+        construct(make, std::make_index_sequence<count>{});
+    }
+    template <class Make, std::size_t... Is>
+    void construct(Make& make, std::index_sequence<Is...>)
+    {
+        std::size_t constructed{};
+        try
+        {
+            ((::new (static_cast<void*>(storage_ + offsets[Is])) element_type<Is>(make(member_tag<Is>{})),
+              ++constructed),
+             ...);
+        }
+        catch (...)
+        {
+            destroy_first(constructed, std::index_sequence<Is...>{});
+            throw;
+        }
+    }
+    template <std::size_t... Is>
+    void destroy_first(std::size_t n, std::index_sequence<Is...>)
+    {
+        ((Is < n ? get<Is>().~element_type<Is>() : void()), ...);
+    }
+    template <class Other, std::size_t... Is>
+    void assign(Other&& other, std::index_sequence<Is...>)
+    {
+        ((get<Is>() = std::forward<Other>(other).template get<Is>()), ...);
+    }
+
+    alignas(MaxAlign<Ts...>::value) unsigned char storage_[(sizeof(Ts) + ...)];
+};
+template <std::size_t I, class... Ts>
+decltype(auto) get(packed_tuple<Ts...>& t)
+{
+    return t.template get<I>();
+}
+template <std::size_t I, class... Ts>
+decltype(auto) get(const packed_tuple<Ts...>& t)
+{
+    return t.template get<I>();
+}
+} // namespace Mp11
+TEST_CASE("packed_tuple")
+{
+    using Mp11::packed_tuple;
+    using Record = packed_tuple<char, double, char, int>;
+    static_assert(std::is_same<Record::order, boost::mp11::mp_list<boost::mp11::mp_size_t<1>, boost::mp11::mp_size_t<3>,
+                                                                   boost::mp11::mp_size_t<0>, boost::mp11::mp_size_t<2>>>::value,
+                  "");
+    static_assert(Record::offsets[0] == 12 && Record::offsets[1] == 0, "");
+    static_assert(Record::offsets[2] == 13 && Record::offsets[3] == 8, "");
+    static_assert(sizeof(Record) == 16, "");
+    static_assert(sizeof(Record) < sizeof(std::tuple<char, double, char, int>), "");
+    static_assert(sizeof(packed_tuple<char, short, char, long long, char>) == 16, "");
+    static_assert(alignof(Record) == alignof(double), "");
+
+    SECTION("get uses declaration order")
+    {
+        Record r{'a', 1.5, 'b', 42};
+        CHECK(Mp11::get<0>(r) == 'a');
+        CHECK(Mp11::get<1>(r) == 1.5);
+        CHECK(Mp11::get<2>(r) == 'b');
+        CHECK(Mp11::get<3>(r) == 42);
+        Mp11::get<3>(r) = 7;
+        CHECK(r.get<3>() == 7);
+    }
+    SECTION("default constructed members are value initialized")
+    {
+        const Record r;
+        CHECK(Mp11::get<0>(r) == '\0');
+        CHECK(Mp11::get<1>(r) == 0.0);
+        CHECK(Mp11::get<3>(r) == 0);
+    }
+    SECTION("non trivial members")
+    {
+        using Named = packed_tuple<bool, std::string, short>;
+        Named a{true, std::string(100, 'x'), 3};
+        Named b{a};
+        CHECK(Mp11::get<1>(b) == std::string(100, 'x'));
+        Named c{std::move(a)};
+        CHECK(Mp11::get<1>(c).size() == 100);
+        Mp11::get<1>(b) = "changed";
+        c = b;
+        CHECK(Mp11::get<1>(c) == "changed");
+        CHECK(Mp11::get<0>(c));
+        CHECK(Mp11::get<2>(c) == 3);
+    }
+}
+/*
+
+stable type ids without RTTI
+
+*/
+#include <unordered_map>
+namespace type_id
+{
+using id_t = std::uint64_t;
+// FNV-1a, the same on every platform with the same type_name spelling
+constexpr auto fnv1a(const string_view& text) -> id_t
+{
+    id_t hash{14695981039346656037ull};
+    for (decltype(text.size()) i = 0; i < text.size(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(text.data()[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+template <class T>
+constexpr auto id_of() -> id_t
+{
+    return fnv1a(type_name<T>());
+}
+// the ids are hashes already, tables keyed by them must not hash again
+struct identity_hash
+{
+    constexpr auto operator()(id_t id) const -> std::size_t
+    {
+        return static_cast<std::size_t>(id);
+    }
+};
+template <class Value>
+using table = std::unordered_map<id_t, Value, identity_hash>;
+class collision : public std::logic_error
+{
+  public:
+    using std::logic_error::logic_error;
+};
+// maps ids back to type names, filled by add<T>() at start-up
+class registry
+{
+  public:
+    template <class T>
+    static auto add() -> id_t
+    {
+        constexpr auto id = id_of<T>();
+        const auto name = type_name<T>();
+        const auto [it, inserted] = names().emplace(id, name);
+        if (!inserted && !(it->second.size() == name.size() && it->second == name))
+            throw collision("two type names share one type id");
+        return id;
+    }
+    [[nodiscard]] static auto name(id_t id) -> string_view
+    {
+        const auto it = names().find(id);
+        return it == names().end() ? string_view{} : it->second;
+    }
+    [[nodiscard]] static auto contains(id_t id) -> bool
+    {
+        return names().count(id) != 0;
+    }
+
+  private:
+    static auto names() -> table<string_view>&
+    {
+        static table<string_view> names;
+        return names;
+    }
+};
+} // namespace type_id
+TEST_CASE("type_name")
+{
+    CHECK(type_name<int>() == string_view("int"));
+    CHECK(type_name<int>().size() == 3);
+    CHECK(type_name<std::map<int, int>>().size() == string_view("std::map<int, int>").size());
+    CHECK(type_name<Mp11::packed_tuple<char, int>>() == string_view("Mp11::packed_tuple<char, int>"));
+}
+TEST_CASE("type ids")
+{
+    static_assert(type_id::fnv1a(string_view("", 0)) == 14695981039346656037ull, "");
+    static_assert(type_id::fnv1a(string_view("a", 1)) == 0xaf63dc4c8601ec8cull, "");
+    static_assert(type_id::id_of<int>() != type_id::id_of<unsigned>(), "");
+    static_assert(type_id::id_of<int>() == type_id::fnv1a(string_view("int", 3)), "");
+
+    const auto id = type_id::registry::add<std::vector<int>>();
+    CHECK(id == type_id::id_of<std::vector<int>>());
+    CHECK(type_id::registry::add<std::vector<int>>() == id);
+    CHECK(type_id::registry::contains(id));
+    CHECK(type_id::registry::name(id).size() == type_name<std::vector<int>>().size());
+    CHECK_FALSE(type_id::registry::contains(type_id::id_of<std::list<int>>()));
+
+    type_id::table<int> dispatch;
+    dispatch[type_id::id_of<int>()] = 1;
+    dispatch[type_id::id_of<double>()] = 2;
+    CHECK(dispatch.at(type_id::id_of<double>()) == 2);
+}
+TEST_CASE("string_view")
+{
+    using namespace std::string_literals;
+    static_assert(string_view("hello").size() == 5, "");
+    static_assert(string_view("hello") == string_view("hello"), "");
+    static_assert(string_view("hell") != string_view("hello"), "");
+    static_assert(string_view("abc").compare(string_view("abd")) < 0, "");
+    static_assert(string_view("abc").compare(string_view("ab")) > 0, "");
+    static_assert(string_view("hello world").find(string_view("wor")) == 6, "");
+    static_assert(string_view("hello world").find('o', 5) == 7, "");
+    const char* const text = "hello";
+    CHECK(string_view(text).size() == 5);
+
+    SECTION("equality")
+    {
+        CHECK_FALSE(string_view("int") == string_view("integer"));
+        CHECK_FALSE(string_view("integer") == string_view("int"));
+        const auto a = std::string(100, 'x') + "a";
+        const auto b = std::string(100, 'x') + "b";
+        CHECK(string_view(a) != string_view(b));
+        CHECK(string_view(a) == string_view(std::string(a)));
+        CHECK(string_view(a) < string_view(b));
+        CHECK(string_view(b).compare(string_view(a)) > 0);
+        CHECK(string_view("\xff").compare(string_view("a")) > 0);
+    }
+    SECTION("find agrees with std::string_view")
+    {
+        std::mt19937 generator(179);
+        std::uniform_int_distribution<int> letter('a', 'c');
+        std::string haystack(200, ' ');
+        for (auto& c : haystack)
+            c = static_cast<char>(letter(generator));
+        const std::string_view expected{haystack};
+        const string_view actual{haystack};
+        for (char c : {'a', 'b', 'c', 'd'})
+        {
+            for (std::size_t pos : {0, 1, 17, 150, 199, 200, 300})
+                CHECK(actual.find(c, pos) == expected.find(c, pos));
+        }
+        for (std::size_t length = 0; length < 24; ++length)
+        {
+            for (std::size_t from : {0, 5, 33, 190})
+            {
+                const auto needle = haystack.substr(from, length);
+                for (std::size_t pos : {0, 1, 40, 180, 200})
+                    CHECK(actual.find(string_view(needle), pos) == expected.find(needle, pos));
+            }
+        }
+        CHECK(actual.find(string_view("abcabcabcd")) == expected.find("abcabcabcd"));
+    }
+    SECTION("key of unordered containers")
+    {
+        std::unordered_map<string_view, int> keys{{"one", 1}, {"two", 2}, {"three", 3}};
+        const auto two = "two"s;
+        CHECK(keys.at(string_view(two)) == 2);
+        CHECK(keys.count(string_view("tw")) == 0);
+        CHECK(string_view(two).hash() == string_view("two").hash());
+    }
+}
+namespace
+{
+auto fieldNames() -> std::vector<std::string>
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i)
+        names.push_back("field_name_number_" + std::to_string(i * 7919));
+    return names;
+}
+} // namespace
+TEST_CASE("string_view benchmark", "[.][benchmark]")
+{
+    const auto names = fieldNames();
+    std::string text(4096, 'x');
+    text += "needle";
+    const auto copy = names.back();
+
+    BENCHMARK("std::string_view ==")
+    {
+        return std::string_view(names.back()) == std::string_view(copy);
+    };
+    BENCHMARK("string_view ==")
+    {
+        return string_view(names.back()) == string_view(copy);
+    };
+    BENCHMARK("std::string_view find char")
+    {
+        return std::string_view(text).find('n');
+    };
+    BENCHMARK("string_view find char")
+    {
+        return string_view(text).find('n');
+    };
+    BENCHMARK("std::string_view find")
+    {
+        return std::string_view(text).find("needle");
+    };
+    BENCHMARK("string_view find")
+    {
+        return string_view(text).find(string_view("needle"));
+    };
+    BENCHMARK_ADVANCED("std::string_view lookup")(Catch::Benchmark::Chronometer meter)
+    {
+        std::unordered_map<std::string_view, int> table;
+        for (const auto& name : names)
+            table.emplace(name, int(table.size()));
+        meter.measure([&] {
+            int sum{};
+            for (const auto& name : names)
+                sum += table.find(std::string_view(name))->second;
+            return sum;
+        });
+    };
+    BENCHMARK_ADVANCED("string_view lookup")(Catch::Benchmark::Chronometer meter)
+    {
+        std::unordered_map<string_view, int> table;
+        for (const auto& name : names)
+            table.emplace(string_view(name), int(table.size()));
+        meter.measure([&] {
+            int sum{};
+            for (const auto& name : names)
+                sum += table.find(string_view(name))->second;
+            return sum;
+        });
+    };
+}
+/*
+
+interning a fixed set of literals with a perfect hash
+
+*/
+namespace intern
+{
+// spreads every bit of x over all bits of the result
+constexpr auto mix(std::uint64_t x) -> std::uint64_t
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+// up to eight characters as one little endian word
+constexpr auto load(const char* data, std::size_t size) -> std::uint64_t
+{
+    std::uint64_t word{};
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (size == 8 && !__builtin_is_constant_evaluated())
+    {
+        std::memcpy(&word, data, 8);
+        return word;
+    }
+#endif
+    for (std::size_t k = 0; k < size; ++k)
+        word |= std::uint64_t(static_cast<unsigned char>(data[k])) << (8 * k);
+    return word;
+}
+// eight characters per multiplication, the same result at compile time
+// and at run time
+constexpr auto hash(const string_view& s) -> std::uint64_t
+{
+    std::uint64_t h{s.size() * 0x9E3779B97F4A7C15ull};
+    std::size_t i{};
+    for (; i + 8 <= s.size(); i += 8)
+    {
+        h = (h ^ load(s.data() + i, 8)) * 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 29;
+    }
+    return mix(h ^ load(s.data() + i, s.size() - i));
+}
+constexpr auto capacity_for(std::size_t n) -> std::size_t
+{
+    std::size_t capacity{1};
+    while (capacity < 2 * n)
+        capacity *= 2;
+    return capacity;
+}
+// maps each of N strings to its index with one hash and one string compare,
+// keys are spread over N buckets and every bucket gets a displacement which
+// sends its keys to free slots, found when the table is built at compile time
+template <std::size_t N>
+class table
+{
+    static_assert(N > 0, "an interning table needs at least one string");
+
+  public:
+    using id_t = std::size_t;
+    constexpr static id_t npos{static_cast<id_t>(-1)};
+    constexpr static std::size_t capacity{capacity_for(N)};
+
+    constexpr explicit table(const std::array<string_view, N>& keys)
+        : keys_{keys}
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = i + 1; j < N; ++j)
+            {
+                if (keys_[i] == keys_[j])
+                    throw std::logic_error("interned strings must be distinct");
+            }
+        }
+        // keys grouped by bucket, buckets ordered by decreasing size
+        std::array<std::size_t, N> bucketSize{};
+        for (const auto& key : keys_)
+            ++bucketSize[bucket(hash(key))];
+        std::array<std::size_t, N + 1> bucketStart{};
+        for (std::size_t b = 0; b < N; ++b)
+            bucketStart[b + 1] = bucketStart[b] + bucketSize[b];
+        std::array<std::size_t, N> members{};
+        std::array<std::size_t, N> filled{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const auto b = bucket(hash(keys_[i]));
+            members[bucketStart[b] + filled[b]++] = i;
+        }
+        std::array<std::size_t, N> order{};
+        for (std::size_t b = 0; b < N; ++b)
+            order[b] = b;
+        for (std::size_t i = 1; i < N; ++i)
+        {
+            for (std::size_t j = i; j > 0 && bucketSize[order[j - 1]] < bucketSize[order[j]]; --j)
+            {
+                const auto swapped = order[j];
+                order[j] = order[j - 1];
+                order[j - 1] = swapped;
+            }
+        }
+        for (const auto b : order)
+        {
+            if (bucketSize[b] == 0)
+                break;
+            displacements_[b] = displace(members, bucketStart[b], bucketStart[b + 1]);
+        }
+    }
+    // the index of s in the strings the table was built from, npos if absent
+    [[nodiscard]] constexpr auto id(const string_view& s) const -> id_t
+    {
+        const auto h = hash(s);
+        const auto entry = slots_[slot(h, displacements_[bucket(h)])];
+        if (entry == 0 || keys_[entry - 1u] != s)
+            return npos;
+        return entry - 1u;
+    }
+    [[nodiscard]] constexpr auto name(id_t id) const -> string_view
+    {
+        return keys_[id];
+    }
+    [[nodiscard]] constexpr auto size() const -> std::size_t
+    {
+        return N;
+    }
+
+  private:
+    using entry_t = Mp11::smallest_unsigned_t<N + 1>;
+
+    constexpr static auto bucket(std::uint64_t hash) -> std::size_t
+    {
+        return static_cast<std::size_t>((hash >> 32) % N);
+    }
+    // double hashing, an odd step visits every slot of the power of two table
+    constexpr static auto slot(std::uint64_t hash, std::uint32_t displacement) -> std::size_t
+    {
+        const auto start = static_cast<std::uint32_t>(hash);
+        const auto step = static_cast<std::uint32_t>(hash >> 16) | 1u;
+        return static_cast<std::size_t>((start + displacement * step) & (capacity - 1));
+    }
+    // the first displacement which puts all keys of a bucket into free slots
+    constexpr auto displace(const std::array<std::size_t, N>& members, std::size_t first, std::size_t last)
+        -> std::uint32_t
+    {
+        for (std::uint32_t displacement = 1; displacement < (1u << 20); ++displacement)
+        {
+            std::array<std::size_t, N> taken{};
+            std::size_t count{};
+            for (auto i = first; i < last; ++i)
+            {
+                const auto candidate = slot(hash(keys_[members[i]]), displacement);
+                bool free = slots_[candidate] == 0;
+                for (std::size_t k = 0; free && k < count; ++k)
+                    free = taken[k] != candidate;
+                if (!free)
+                    break;
+                taken[count++] = candidate;
+            }
+            if (count == last - first)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                    slots_[taken[k]] = static_cast<entry_t>(members[first + k] + 1);
+                return displacement;
+            }
+        }
+        throw std::logic_error("no perfect hash found");
+    }
+
+    std::array<string_view, N> keys_{};
+    std::array<std::uint32_t, N> displacements_{};
+    // index + 1 of the key in each slot, 0 for free slots
+    std::array<entry_t, capacity> slots_{};
+};
+template <class... Strings>
+constexpr auto make_table(const Strings&... strings) -> table<sizeof...(Strings)>
+{
+    return table<sizeof...(Strings)>{std::array<string_view, sizeof...(Strings)>{string_view(strings)...}};
+}
+} // namespace intern
+namespace
+{
+constexpr auto keywords = intern::make_table(
+    "alignas", "alignof", "and", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+    "char16_t", "char32_t", "class", "compl", "const", "constexpr", "const_cast", "continue", "decltype", "default",
+    "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float",
+    "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not",
+    "nullptr", "operator", "or", "private", "protected", "public", "register", "reinterpret_cast", "return",
+    "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+    "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+    "virtual", "void", "volatile", "wchar_t", "while", "xor");
+} // namespace
+TEST_CASE("interning table")
+{
+    static_assert(keywords.size() == 80, "");
+    static_assert(keywords.id("alignas") == 0, "");
+    static_assert(keywords.id("xor") == 79, "");
+    static_assert(keywords.id("constexpr") == 17, "");
+    static_assert(keywords.id("constexp") == keywords.npos, "");
+    static_assert(keywords.name(17) == string_view("constexpr"), "");
+    static_assert(intern::make_table("one").id("one") == 0, "");
+    static_assert(intern::hash(string_view("twelve chars")) != intern::hash(string_view("twelve charz")), "");
+
+    for (std::size_t id = 0; id < keywords.size(); ++id)
+    {
+        const std::string input(keywords.name(id).data(), keywords.name(id).size());
+        CHECK(keywords.id(string_view(input)) == id);
+    }
+    for (const char* unknown : {"", "x", "Int", "int ", "whilst", "static_asser", "reinterpret_cast_"})
+        CHECK(keywords.id(string_view(unknown)) == keywords.npos);
+}
+TEST_CASE("interning table benchmark", "[.][benchmark]")
+{
+    std::vector<std::string> inputs;
+    for (std::size_t id = 0; id < keywords.size(); ++id)
+        inputs.emplace_back(keywords.name(id).data(), keywords.name(id).size());
+    inputs.emplace_back("identifier");
+    std::unordered_map<std::string_view, std::size_t> map;
+    for (std::size_t id = 0; id < keywords.size(); ++id)
+        map.emplace(std::string_view(inputs[id]), id);
+
+    BENCHMARK("std::unordered_map")
+    {
+        std::size_t sum{};
+        for (const auto& input : inputs)
+        {
+            const auto it = map.find(std::string_view(input));
+            sum += it == map.end() ? 0 : it->second;
+        }
+        return sum;
+    };
+    BENCHMARK("intern::table")
+    {
+        std::size_t sum{};
+        for (const auto& input : inputs)
+        {
+            const auto id = keywords.id(string_view(input));
+            sum += id == keywords.npos ? 0 : id;
+        }
+        return sum;
+    };
+}